@@ -0,0 +1,427 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "io.h"
+#include "server.h"
+
+#include "broadcast.h"
+
+using namespace std;
+
+// The ring holds the last ring_size bytes published. Positions count every
+// byte ever published, so position % ring_size is where a byte is in the ring
+static size_t constexpr ring_size = 1 << 20;
+
+struct Watcher {
+  int                fd;
+  unsigned long long position;  // Next byte to send
+  bool               waiting;   // For a keyframe after position
+};
+
+static mutex              ring_mutex;         // Guards the ring and the five below
+static vector<char>       ring;               // Empty until someone watches
+static unsigned long long published = 0;      // Bytes ever published
+static unsigned long long keyframe = 0;       // Where the latest keyframe starts
+static bool               has_keyframe = false;
+static int                watching = 0;       // Watchers connected now
+static string             idle_keyframe;      // The screen, while nobody watches
+
+static atomic<bool> keyframe_wanted(true);
+static atomic<bool> stopping(false);
+static thread*      broadcaster = nullptr;
+static int          listener = -1;
+static int          wake[2] = { -1, -1 };     // Pipe to wake the broadcaster
+static string       socket_path;
+
+// What publish() sent last, so it only has to send changes. Only the game's
+// thread touches these
+static chtype frame[NUMLINES][NUMCOLS];
+static chtype frame_attributes = 0;
+static int    frame_x = 0;
+static int    frame_y = 0;
+static string encoded;
+
+static void set_nonblocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void encode_move(int x, int y) {
+  if (x == frame_x && y == frame_y) {
+    return;
+  }
+  char escape[32];
+  snprintf(escape, sizeof(escape), "\033[%d;%dH", y + 1, x + 1);
+  encoded += escape;
+  frame_x = x;
+  frame_y = y;
+}
+
+static void encode_attributes(chtype attributes) {
+  if (attributes == frame_attributes) {
+    return;
+  }
+
+  encoded += "\033[0";
+  if (attributes & A_BOLD) {
+    encoded += ";1";
+  }
+  if (attributes & A_UNDERLINE) {
+    encoded += ";4";
+  }
+  if (attributes & (A_STANDOUT | A_REVERSE)) {
+    encoded += ";7";
+  }
+  short foreground = -1;
+  short background = -1;
+  short pair = static_cast<short>(PAIR_NUMBER(attributes));
+  if (pair != 0 && pair_content(pair, &foreground, &background) == OK &&
+      foreground >= 0 && foreground < 8) {
+    encoded += ";3";
+    encoded += static_cast<char>('0' + foreground);
+  }
+  encoded += 'm';
+  frame_attributes = attributes;
+}
+
+// Put what's on screen into encoded, as changes since the last frame
+static void encode_screen(bool full) {
+  if (full) {
+    encoded += "\033[0m\033[H\033[2J";
+    for (auto& row : frame) {
+      for (chtype& cell : row) {
+        cell = ' ';
+      }
+    }
+    frame_attributes = 0;
+    frame_x = 0;
+    frame_y = 0;
+  }
+
+  // curscr is what curses believes is on the terminal
+  int cursor_y;
+  int cursor_x;
+  getyx(curscr, cursor_y, cursor_x);
+
+  chtype row[NUMCOLS + 1];
+  for (int y = 0; y < NUMLINES; ++y) {
+    int const length = mvwinchnstr(curscr, y, 0, row, NUMCOLS);
+    for (int x = 0; x < NUMCOLS; ++x) {
+      chtype const cell = x < length ? row[x] : ' ';
+      if (cell == frame[y][x]) {
+        continue;
+      }
+
+      chtype ch = cell & A_CHARTEXT;
+      if (ch < ' ' || ch > '~') {
+        ch = ' ';
+      }
+      encode_move(x, y);
+      encode_attributes(cell & (A_ATTRIBUTES & ~A_ALTCHARSET));
+      encoded += static_cast<char>(ch);
+      frame[y][x] = cell;
+
+      // Terminals differ in what they do at the right margin
+      frame_x = x + 1 < NUMCOLS ? x + 1 : -1;
+    }
+  }
+
+  wmove(curscr, cursor_y, cursor_x);
+  encode_move(cursor_x, cursor_y);
+}
+
+// Add data to the ring. Call with ring_mutex held
+static void write_ring(string const& data) {
+  if (ring.empty()) {
+    ring.resize(ring_size);
+  }
+  size_t const start = static_cast<size_t>(published % ring_size);
+  size_t const first = min(data.size(), ring_size - start);
+  memcpy(ring.data() + start, data.data(), first);
+  memcpy(ring.data(), data.data() + first, data.size() - first);
+  published += data.size();
+}
+
+// Copy bytes from position on into buffer, or return false if the ring has
+// already been overwritten there. Call with ring_mutex held
+static bool read_ring(unsigned long long position, vector<char>& buffer, size_t& size) {
+  if (published - position > ring_size) {
+    return false;
+  }
+
+  size = static_cast<size_t>(min<unsigned long long>(published - position, buffer.size()));
+  size_t const start = static_cast<size_t>(position % ring_size);
+  size_t const first = min(size, ring_size - start);
+  memcpy(buffer.data(), ring.data() + start, first);
+  memcpy(buffer.data() + first, ring.data(), size - first);
+  return true;
+}
+
+// Send watcher what it has not seen yet. Returns false if it went away
+static bool send_watcher(Watcher& watcher, vector<char>& buffer) {
+  size_t size = 0;
+  {
+    lock_guard<mutex> lock(ring_mutex);
+    if (watcher.waiting) {
+      if (!has_keyframe || keyframe < watcher.position) {
+        return true;
+      }
+      watcher.position = keyframe;
+      watcher.waiting = false;
+    }
+
+    if (!read_ring(watcher.position, buffer, size)) {
+      // Fell too far behind. Start over from a new keyframe
+      watcher.position = published;
+      watcher.waiting = true;
+      keyframe_wanted = true;
+      return true;
+    }
+  }
+
+  if (size == 0) {
+    return true;
+  }
+
+  ssize_t sent = send(watcher.fd, buffer.data(), size, MSG_NOSIGNAL | MSG_DONTWAIT);
+  if (sent < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  watcher.position += static_cast<size_t>(sent);
+  return true;
+}
+
+static bool has_unsent(Watcher const& watcher) {
+  lock_guard<mutex> lock(ring_mutex);
+  return watcher.waiting
+    ? has_keyframe && keyframe >= watcher.position
+    : watcher.position < published;
+}
+
+static void add_watcher(vector<Watcher>& watchers) {
+  int fd = accept(listener, nullptr, nullptr);
+  if (fd < 0) {
+    return;
+  }
+  set_nonblocking(fd);
+
+  // The latest keyframe and everything after it make up the screen. If it's
+  // gone, the next publish() writes a new one
+  lock_guard<mutex> lock(ring_mutex);
+  if (watching++ == 0 && !idle_keyframe.empty()) {
+    keyframe = published;
+    has_keyframe = true;
+    write_ring(idle_keyframe);
+    idle_keyframe.clear();
+  }
+
+  if (has_keyframe && published - keyframe <= ring_size) {
+    watchers.push_back({ fd, keyframe, false });
+  } else {
+    watchers.push_back({ fd, published, true });
+    keyframe_wanted = true;
+  }
+}
+
+static void broadcast_loop() {
+  vector<Watcher> watchers;
+  vector<pollfd>  fds;
+  vector<char>    buffer(64 * 1024);
+
+  while (!stopping) {
+    fds.clear();
+    fds.push_back({ wake[0], POLLIN, 0 });
+    fds.push_back({ listener, POLLIN, 0 });
+    for (Watcher const& watcher : watchers) {
+      short events = POLLIN;
+      if (has_unsent(watcher)) {
+        events |= POLLOUT;
+      }
+      fds.push_back({ watcher.fd, events, 0 });
+    }
+
+    if (poll(fds.data(), fds.size(), -1) < 0 && errno != EINTR) {
+      break;
+    }
+
+    if (fds.at(0).revents != 0) {
+      char drain[256];
+      while (read(wake[0], drain, sizeof(drain)) > 0) {
+        ;
+      }
+    }
+
+    // What watchers send is ignored, but reading nothing means they left
+    for (size_t i = watchers.size(); i-- > 0;) {
+      short const revents = fds.at(i + 2).revents;
+      char ignored[64];
+      bool leaving = (revents & (POLLERR | POLLHUP | POLLNVAL)) ||
+        ((revents & POLLIN) && recv(watchers.at(i).fd, ignored, sizeof(ignored), MSG_DONTWAIT) <= 0);
+      if (leaving || !send_watcher(watchers.at(i), buffer)) {
+        close(watchers.at(i).fd);
+        watchers.erase(watchers.begin() + static_cast<long>(i));
+        lock_guard<mutex> lock(ring_mutex);
+        --watching;
+      }
+    }
+
+    if (fds.at(1).revents != 0) {
+      add_watcher(watchers);
+    }
+  }
+
+  for (Watcher const& watcher : watchers) {
+    close(watcher.fd);
+  }
+  lock_guard<mutex> lock(ring_mutex);
+  watching = 0;
+}
+
+bool Broadcast::start(string const& path) {
+  if (broadcaster != nullptr) {
+    return false;
+  }
+
+  listener = Server::listen_on(path, 0666);
+  if (listener < 0) {
+    return false;
+  }
+  if (pipe(wake) != 0) {
+    close(listener);
+    return false;
+  }
+  set_nonblocking(wake[0]);
+  set_nonblocking(wake[1]);
+
+  socket_path = path;
+  stopping = false;
+  broadcaster = new thread(broadcast_loop);
+  return true;
+}
+
+void Broadcast::stop() {
+  if (broadcaster == nullptr) {
+    return;
+  }
+
+  stopping = true;
+  if (write(wake[1], "", 1) < 0) {
+    // The pipe is full, so the broadcaster is awake anyway
+  }
+  broadcaster->join();
+  delete broadcaster;
+  broadcaster = nullptr;
+
+  close(listener);
+  close(wake[0]);
+  close(wake[1]);
+  unlink(socket_path.c_str());
+}
+
+void Broadcast::publish() {
+  if (broadcaster == nullptr || Game::io == nullptr || Game::io->is_headless()) {
+    return;
+  }
+
+  // A keyframe now and then keeps what joiners have to catch up with short.
+  // While nobody watches, only the whole screen is kept, for the first one
+  // to join. Served games are mostly not watched, so they don't need a ring
+  bool full = keyframe_wanted.exchange(false);
+  {
+    lock_guard<mutex> lock(ring_mutex);
+    full = full || watching == 0 || !has_keyframe || published - keyframe > ring_size / 2;
+  }
+
+  encoded.clear();
+  encode_screen(full);
+  if (encoded.empty()) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(ring_mutex);
+    if (full && watching == 0) {
+      idle_keyframe = encoded;
+      has_keyframe = false;
+      return;
+    }
+
+    if (full) {
+      keyframe = published;
+      has_keyframe = true;
+    }
+    write_ring(encoded);
+  }
+
+  if (write(wake[1], "", 1) < 0) {
+    // The pipe is full, so the broadcaster will wake up anyway
+  }
+}
+
+int Broadcast::watch(string const& path) {
+  int game = Server::connect_to(path);
+  if (game < 0) {
+    cerr << path << ": " << strerror(errno) << "\n";
+    return 1;
+  }
+
+  // Keys are not echoed, and q leaves right away
+  termios original;
+  bool const is_terminal = tcgetattr(STDIN_FILENO, &original) == 0;
+  if (is_terminal) {
+    termios raw = original;
+    cfmakeraw(&raw);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+  }
+
+  pollfd fds[2] = {
+    { STDIN_FILENO, POLLIN, 0 },
+    { game,         POLLIN, 0 },
+  };
+  char buffer[4096];
+  for (;;) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    if (fds[0].revents != 0) {
+      char ch;
+      if (read(STDIN_FILENO, &ch, 1) <= 0 || ch == 'q' || ch == KEY_ESCAPE) {
+        break;
+      }
+    }
+
+    if (fds[1].revents != 0) {
+      ssize_t size_read = read(game, buffer, sizeof(buffer));
+      if (size_read <= 0 ||
+          !Server::write_all(STDOUT_FILENO, buffer, static_cast<size_t>(size_read))) {
+        break;
+      }
+    }
+  }
+
+  static char const reset[] = "\033[0m\r\n";
+  Server::write_all(STDOUT_FILENO, reset, sizeof(reset) - 1);
+  if (is_terminal) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &original);
+  }
+  close(game);
+  return 0;
+}
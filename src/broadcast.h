@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+// Letting others watch a game over a Unix domain socket
+//
+// Whenever the screen settles, publish() compares it to the last screen it
+// sent and writes the difference as VT100 escapes into a ring buffer. A thread
+// of its own accepts watchers and sends each of them the ring from where they
+// are, so the game does the same work for one watcher as for a hundred.
+// While nobody watches, only the latest screen is kept.
+// Watchers start at the latest keyframe (a full screen), which the game
+// writes when someone joins or falls too far behind.
+//
+// Connect with `misty_mountains --watch=SOCKET`. Games served with --serve
+// are broadcast on SOCKET.NAME.
+namespace Broadcast {
+
+// Listen for watchers on path. Returns false if that failed
+bool start(std::string const& path);
+
+// Disconnect everyone and stop listening
+void stop();
+
+// Send what changed on screen since last time, if anyone could be watching
+void publish();
+
+// Watch the game at path until it ends or q is pressed. Returns an exit status
+int watch(std::string const& path);
+
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <string>
+
+#include "error_handling.h"
+
+#include "cell_set.h"
+
+using namespace std;
+
+CellSet::CellSet() : pos(0, 0), box(0, 0), bits(), count(0) {}
+
+CellSet::CellSet(Coordinate const& pos_, Coordinate const& size)
+  : pos(pos_), box(max(size.x, 0), max(size.y, 0)), bits(), count(0) {
+
+  bits.resize((static_cast<size_t>(box.x * box.y) + 63) / 64);
+}
+
+void CellSet::set(int x, int y, bool member) {
+  x -= pos.x;
+  y -= pos.y;
+  if (x < 0 || x >= box.x || y < 0 || y >= box.y) {
+    return;
+  }
+
+  size_t const i = static_cast<size_t>(y * box.x + x);
+  uint64_t const bit = uint64_t(1) << (i % 64);
+  uint64_t& word = bits.at(i / 64);
+  if (member && !(word & bit)) {
+    word |= bit;
+    ++count;
+  } else if (!member && (word & bit)) {
+    word &= ~bit;
+    --count;
+  }
+}
+
+bool CellSet::contains(int x, int y) const {
+  x -= pos.x;
+  y -= pos.y;
+  if (x < 0 || x >= box.x || y < 0 || y >= box.y) {
+    return false;
+  }
+
+  size_t const i = static_cast<size_t>(y * box.x + x);
+  return bits.at(i / 64) & (uint64_t(1) << (i % 64));
+}
+
+bool CellSet::contains_any(Coordinate const& from, Coordinate const& to) const {
+  int const min_x = max(from.x - pos.x, 0);
+  int const max_x = min(to.x - pos.x, box.x - 1);
+  if (min_x > max_x) {
+    return false;
+  }
+
+  // A row of the box at a time, a word at a time
+  for (int y = max(from.y - pos.y, 0); y <= min(to.y - pos.y, box.y - 1); ++y) {
+    size_t i = static_cast<size_t>(y * box.x + min_x);
+    size_t const end = static_cast<size_t>(y * box.x + max_x) + 1;
+    while (i < end) {
+      size_t const bit = i % 64;
+      size_t const length = min(end - i, 64 - bit);
+      uint64_t const mask = (length == 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1) << bit;
+      if (bits.at(i / 64) & mask) {
+        return true;
+      }
+      i += length;
+    }
+  }
+  return false;
+}
+
+uint64_t CellSet::row(int x, int y) const {
+  y -= pos.y;
+  x -= pos.x;
+  if (y < 0 || y >= box.y || x >= box.x || x <= -64) {
+    return 0;
+  }
+
+  // Tiles left of the box are not members
+  int const skip = max(-x, 0);
+  x += skip;
+  size_t const length = static_cast<size_t>(min(box.x - x, 64 - skip));
+
+  size_t const i = static_cast<size_t>(y * box.x + x);
+  size_t const bit = i % 64;
+  uint64_t tiles = bits.at(i / 64) >> bit;
+  if (bit != 0 && i / 64 + 1 < bits.size()) {
+    tiles |= bits.at(i / 64 + 1) << (64 - bit);
+  }
+  if (length < 64) {
+    tiles &= (uint64_t(1) << length) - 1;
+  }
+  return tiles << skip;
+}
+
+size_t CellSet::size() const {
+  return count;
+}
+
+Coordinate CellSet::at(size_t n) const {
+  if (n >= count) {
+    error("CellSet member " + to_string(n) + " out of range");
+  }
+
+  // Skip whole words, then bits
+  size_t word = 0;
+  for (;; ++word) {
+    size_t const members = static_cast<size_t>(__builtin_popcountll(bits.at(word)));
+    if (n < members) {
+      break;
+    }
+    n -= members;
+  }
+
+  uint64_t bitset = bits.at(word);
+  for (; n > 0; --n) {
+    bitset &= bitset - 1;
+  }
+  int const i = static_cast<int>(word * 64) + __builtin_ctzll(bitset);
+  return Coordinate(pos.x + i % box.x, pos.y + i / box.x);
+}
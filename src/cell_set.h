@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "coordinate.h"
+
+// Some of the tiles in a box on the map, as a bit per tile
+//
+// Level keeps one per room for the tiles random placement can use, see
+// Level::get_random_room_coord(), and some for the whole map for what stops
+// a run, see Level::is_run_stop(). Members are numbered in reading
+// order, so which tile a number gives depends only on what is in the set,
+// not on how it got there.
+class CellSet {
+public:
+  CellSet();
+  CellSet(Coordinate const& pos, Coordinate const& size); // Empty box
+
+  // Add or remove a tile. Tiles outside the box are ignored
+  void set(int x, int y, bool member);
+
+  bool   contains(int x, int y) const;
+  bool   contains_any(Coordinate const& from, Coordinate const& to) const; // In the box, inclusive
+  uint64_t row(int x, int y) const; // Tiles x to x + 63 of row y, x as bit 0
+  size_t size() const;
+
+  // Member n, 0 <= n < size()
+  Coordinate at(size_t n) const;
+
+private:
+  Coordinate            pos;
+  Coordinate            box;
+  std::vector<uint64_t> bits;   // Reading order, a row at a time
+  size_t                count;
+};
@@ -232,7 +232,7 @@ void Character::set_position(Coordinate const& position_) {
 }
 
 
-void Character::save(ofstream& data) const {
+void Character::save(ostream& data) const {
   Disk::save_tag(TAG_CHARACTER, data);
   Disk::save(TAG_CHARACTER, strength, data);
   Disk::save(TAG_CHARACTER, default_strength, data);
@@ -270,7 +270,7 @@ void Character::save(ofstream& data) const {
   Disk::save(TAG_CHARACTER, attack_drain_experience, data);
 }
 
-bool Character::load(ifstream& data) {
+bool Character::load(istream& data) {
   if (!Disk::load_tag(TAG_CHARACTER, data) ||
       !Disk::load(TAG_CHARACTER, strength, data) ||
       !Disk::load(TAG_CHARACTER, default_strength, data) ||
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <csignal>
+#include <cctype>
+#include <cstring>
 #include <string>
 
 #include "game.h"
@@ -12,10 +15,13 @@
 #include "options.h"
 #include "player.h"
 #include "potions.h"
+#include "profile.h"
 #include "rings.h"
 #include "rogue.h"
+#include "scheduler.h"
 #include "score.h"
 #include "scrolls.h"
+#include "travel.h"
 #include "wand.h"
 #include "weapons.h"
 #include "wizard.h"
@@ -25,6 +31,11 @@
 
 using namespace std;
 
+static int constexpr max_count = 9999;
+static char repeat_ch = '\0';  /* Command given a count, see command_count() */
+static int  repeats_left = 0;
+static volatile sig_atomic_t interrupted = 0; /* See command_signal_interrupt() */
+
 static bool
 unknown_command(char ch)
 {
@@ -45,51 +56,130 @@ command_stop(bool stop_fighting)
   return false;
 }
 
-int
-command()
+/* Read the rest of a count like 20s, and do the command that many times. The
+ * repeats come back through runch, like running does, and stop on the same
+ * things which stop a run */
+static bool
+command_count(char ch)
+{
+  int count = 0;
+  while (isdigit(ch))
+  {
+    count = min(count * 10 + ch - '0', max_count);
+    ch = io_readchar(false);
+  }
+
+  /* Commands which ask for something would ask every time */
+  if (count > 1 && ch != '\0' && strchr(".shjklyubn", ch) != nullptr)
+  {
+    repeat_ch = ch;
+    repeats_left = count;
+    runch = ch;
+    player_alerted = false;
+    player->set_running();
+  }
+  return command_do(ch);
+}
+
+bool
+command_repeating()
+{
+  return repeats_left > 0 && runch == repeat_ch && player->is_running();
+}
+
+void
+command_turn_begin()
 {
   Daemons::daemon_run_before();
+}
 
-  int num_moves = 1;
-  num_moves += player->get_speed();
+bool
+command_player_due()
+{
+  return player->get_next_action() < Schedule::turn_start() + Schedule::ticks_per_turn;
+}
 
-  while (num_moves-- > 0)
-  {
-    Game::io->refresh();
+bool
+command_move_begin()
+{
+  Game::io->refresh();
 
-    if (player_turns_without_action > 0 &&
-        --player_turns_without_action == 0) {
-      Game::io->message("you can move again");
-    }
+  if (player_turns_without_action > 0 &&
+      --player_turns_without_action == 0) {
+    Game::io->message("you can move again");
+  }
 
-    if (!player_turns_without_action) {
+  return !player_turns_without_action;
+}
 
-      char ch;
+void
+command_move_end(bool took_time)
+{
+  /* Moves which took no time (like changing options) come again */
+  if (!took_time)
+    return;
+
+  long long tick = max(player->get_next_action(), Schedule::turn_start());
+  player->set_next_action(tick + Schedule::delay(1 + player->get_speed()));
+}
+
+void
+command_turn_end()
+{
+  player->digest_food();
+  Daemons::daemon_run_after();
+  ++Game::turns;
+  Profile::end_turn();
+}
+
+int
+command()
+{
+  command_turn_begin();
+
+  while (command_player_due())
+  {
+    if (!command_move_begin())
+    {
+      command_move_end(true);
+      continue;
+    }
 
-      if (player->is_running() || to_death)
-        ch = runch;
-      else
-      {
-        ch = io_readchar(false);
-        Game::io->clear_message();
-      }
+    /* Game::end() throws, so it cannot be reached from the signal handler */
+    if (interrupted)
+    {
+      interrupted = 0;
+      command_signal_quit(0);
+    }
 
-      /* command_do returns 0 if player did something not in-game
-       * (like changing options), thus recevies another turn */
-      if (!command_do(ch))
-        num_moves++;
+    char ch;
 
+    if (player->is_running() || to_death)
+      ch = runch;
+    else
+    {
+      ch = io_readcommand();
+      Game::io->clear_message();
     }
+
+    command_move_end(command_do(ch));
   }
 
-  player->digest_food();
-  Daemons::daemon_run_after();
+  command_turn_end();
   return 0;
 }
 
 bool
 command_do(char ch)
 {
+  PROFILE_SCOPE(Command);
+
+  if (command_repeating() && (--repeats_left == 0 || player_alerted))
+  {
+    repeats_left = 0;
+    player->set_not_running();
+  }
+
   switch (ch)
   {
     /* Funny symbols */
@@ -101,6 +191,9 @@ command_do(char ch)
     case '<': return command_use_stairs(ch);
     case '?': return command_help();
     case '^': return command_identify_trap();
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+      return command_count(ch);
 
     /* Lower case */
     case 'h': case 'j': case 'k': case 'l':
@@ -109,6 +202,7 @@ command_do(char ch)
     case 'a': return command_attack(false);
     case 'c': return command_close();
     case 'e': return command_eat();
+    case 'g': return Travel::travel(ch);
     case 'o': return command_open();
     case 'q': return potion_quaff_something();
     case 'r': return command_read_scroll();
@@ -127,6 +221,7 @@ command_do(char ch)
     case 'I': return player->pack_show_inventory();
     case 'O': return option();
     case 'S': return command_save();
+    case 'X': return Travel::explore(ch);
     case 'Q': return command_quit();
     case 'Z': return command_rest();
 
@@ -159,6 +254,7 @@ command_wizard_do(char ch)
       Game::io->message("food left: " + to_string(player->get_nutrition_left()));
     } break;
     case CTRL('F'): wizard_show_map(); break;
+    case CTRL('G'): Profile::show(); break;
     case CTRL('I'): wizard_levels_and_gear(); break;
     case CTRL('Q'): Game::level->wizard_show_passages(); break;
     case CTRL('T'): player->teleport(nullptr); break;
@@ -186,6 +282,12 @@ command_signal_endit(__attribute__((unused)) int sig)
   Game::exit();
 }
 
+void
+command_signal_interrupt(__attribute__((unused)) int sig)
+{
+  interrupted = 1;
+}
+
 void
 command_signal_quit(__attribute__((unused)) int sig)
 {
@@ -200,7 +302,7 @@ command_signal_quit(__attribute__((unused)) int sig)
   /* Reset the signal in case we got here via an interrupt */
     signal(SIGINT, command_signal_leave);
     player->pack_print_value();
-    score_show_and_exit(player->get_gold(), 1, 0);
+    Game::end(Game::Result::Quit);
   }
   else
   {
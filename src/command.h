@@ -1,10 +1,22 @@
 #pragma once
 
 int command(); /* Processes the user commands */
+
+/* The steps of command(), for callers which supply the keys themselves */
+void command_turn_begin();  /* Run daemons */
+bool command_player_due();  /* True while player has a move left this turn */
+bool command_move_begin();  /* Refresh screen, returns true if player can act */
+void command_move_end(bool took_time); /* Schedule player's next move */
+void command_turn_end();    /* Digest food and let monsters move */
+bool command_do(char ch);   /* Execute command, returns true if it took time */
 bool command_stop(bool stop_fighting);
+bool command_repeating();   /* True while a command given a count is repeating */
 
 void command_signal_quit(int sig);  /* Have player make certain, then exit */
 
+/* SIGINT handler. Only notes it, command() calls command_signal_quit() */
+void command_signal_interrupt(int sig);
+
 /* Exit the program abnormally  */
 void command_signal_endit(int sig) __attribute__((noreturn));
 
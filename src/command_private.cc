@@ -22,6 +22,7 @@
 #include "rogue.h"
 #include "score.h"
 #include "scrolls.h"
+#include "server.h"
 #include "traps.h"
 #include "wand.h"
 #include "weapons.h"
@@ -102,7 +103,7 @@ bool command_use_stairs(char up_or_down) {
 
     if (Game::current_level == 1) {
       if (has_amulet) {
-        score_win_and_exit();
+        score_win();
       } else {
         if (Game::level->shop == nullptr) {
           Game::level->shop = new Shop();
@@ -268,7 +269,7 @@ bool command_pick_up(bool force) {
         }
 
         player->give_gold(value);
-        Game::level->items.remove(obj);
+        Game::level->remove_item(obj);
 
         delete obj;
         it = items_here.erase(it);
@@ -329,14 +330,17 @@ bool command_help() {
     {'Q',	"	quit",					true},
     {'S',	"	save game",				true},
     {'U',	"	run up & right",			false},
+    {'X',	"	explore until interrupted",		true},
     {'Y',	"	run up & left",				false},
     {'Z',	"	rest until healed",			true},
     {'\0',	"	<CTRL><dir>: run till adjacent",	true},
     {'\0',	"	<SHIFT><dir>: run that way",		true},
+    {'\0',	"	<count><dir/./s>: repeat it",		true},
     {'^',	"	identify trap type",			true},
     {'a',	"	attack in a direction",			true},
     {'b',	"	down & left",				true},
     {'e',	"	eat food",				true},
+    {'g',	"	go to a place you have found",		true},
     {'h',	"	left",					true},
     {'j',	"	down",					true},
     {'k',	"	up",					true},
@@ -432,6 +436,12 @@ bool command_help() {
 
 /* Let them escape for a while */
 void command_shell() {
+  // Nobody would be there to wake us up
+  if (Server::in_session()) {
+    Game::io->message("you cannot suspend a game on a server");
+    return;
+  }
+
   /* Set the terminal back to original mode */
   move(LINES-1, 0);
   refresh();
@@ -642,7 +652,7 @@ bool command_save() {
 
   if (io_readchar(true) == 'y') {
     if (Game::save()) {
-      Game::exit();
+      Game::end(Game::Result::Saved);
     }
   }
 
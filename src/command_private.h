@@ -5,7 +5,6 @@
 #include "command.h"
 
 // In command.c
-bool command_do(char ch);
 bool command_wizard_do(char ch);
 
 // In command_sub.c
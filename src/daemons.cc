@@ -12,6 +12,7 @@
 #include "level.h"
 #include "options.h"
 #include "os.h"
+#include "profile.h"
 #include "rogue.h"
 
 #include "daemons.h"
@@ -21,7 +22,10 @@ using namespace std;
 static list<Daemons::Daemon>* daemons = nullptr;
 static list<Daemons::Fuse>*   fuses = nullptr;
 
+static int quiet_rounds = 0;
+
 void Daemons::init_daemons() {
+  quiet_rounds = 0;
   daemons = new list<Daemon>;
   fuses   = new list<Fuse>;
 }
@@ -29,17 +33,20 @@ void Daemons::init_daemons() {
 static unsigned long long constexpr TAG_DAEMONS   = 0x5000000000000000ULL;
 static unsigned long long constexpr TAG_DAEMONLIST= 0x5000000000000001ULL;
 static unsigned long long constexpr TAG_FUSELIST  = 0x5000000000000002ULL;
+static unsigned long long constexpr TAG_QUIETROUNDS = 0x5000000000000003ULL;
 
-void Daemons::save_daemons(std::ofstream& data) {
+void Daemons::save_daemons(std::ostream& data) {
   Disk::save_tag(TAG_DAEMONS, data);
   Disk::save(TAG_DAEMONLIST, daemons, data);
   Disk::save(TAG_FUSELIST, fuses, data);
+  Disk::save(TAG_QUIETROUNDS, quiet_rounds, data);
 }
 
-void Daemons::load_daemons(std::ifstream& data) {
+void Daemons::load_daemons(std::istream& data) {
   if (!Disk::load_tag(TAG_DAEMONS, data))             { error("No daemons found"); }
   if (!Disk::load(TAG_DAEMONLIST, daemons, data))     { error("Daemon tag error 1"); }
   if (!Disk::load(TAG_FUSELIST, fuses, data))         { error("Daemon tag error 2"); }
+  if (!Disk::load(TAG_QUIETROUNDS, quiet_rounds, data)) { error("Daemon tag error 3"); }
 }
 
 void Daemons::free_daemons() {
@@ -50,7 +57,6 @@ void Daemons::free_daemons() {
   fuses = nullptr;
 }
 
-static int quiet_rounds = 0;
 
 static void execute_daemon_function(Daemons::daemon_function func) {
   switch(func) {
@@ -91,11 +97,13 @@ static void daemon_run_fuses(int flag) {
 }
 
 void Daemons::daemon_run_before() {
+  PROFILE_SCOPE(DaemonsBefore);
   daemon_run_all(BEFORE);
   daemon_run_fuses(BEFORE);
 }
 
 void Daemons::daemon_run_after() {
+  PROFILE_SCOPE(DaemonsAfter);
   daemon_run_all(AFTER);
   daemon_run_fuses(AFTER);
 }
@@ -7,8 +7,8 @@
 namespace Daemons {
 
 void init_daemons();
-void save_daemons(std::ofstream&);
-void load_daemons(std::ifstream&);
+void save_daemons(std::ostream&);
+void load_daemons(std::istream&);
 void free_daemons();
 
 enum daemon_function {
@@ -52,7 +52,9 @@ static void death(int type) {
   io_readchar(false);
 
   player->pack_print_value();
-  score_show_and_exit(player->get_gold(), player->pack_contains_amulet() ? 3 : 0, type);
+  Game::end(player->pack_contains_amulet()
+      ? Game::Result::KilledWithAmulet
+      : Game::Result::Killed, type);
 }
 
 void death(enum death_reason reason) {
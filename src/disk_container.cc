@@ -3,7 +3,7 @@
 using namespace std;
 
 template <>
-bool Disk::load<vector, bool>(tag_type tag, vector<bool>& container, std::ifstream& data) {
+bool Disk::load<vector, bool>(tag_type tag, vector<bool>& container, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
 
   size_t size;
@@ -1,6 +1,6 @@
 
 template <template <class, class> class C, class T>
-void save(tag_type tag, C<T, std::allocator<T>> const& container, std::ofstream& data) {
+void save(tag_type tag, C<T, std::allocator<T>> const& container, std::ostream& data) {
   save_tag(tag, data);
 
   size_t size = container.size();
@@ -11,7 +11,7 @@ void save(tag_type tag, C<T, std::allocator<T>> const& container, std::ofstream&
   }
 }
 template <template <class, class> class C, class T>
-bool load(tag_type tag, C<T, std::allocator<T>>& container, std::ifstream& data) {
+bool load(tag_type tag, C<T, std::allocator<T>>& container, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
 
   size_t size;
@@ -27,4 +27,4 @@ bool load(tag_type tag, C<T, std::allocator<T>>& container, std::ifstream& data)
 
 // Special case for vector<bool> since it wanna feel special
 template <>
-bool load<std::vector, bool>(tag_type tag, std::vector<bool>& container, std::ifstream& data);
+bool load<std::vector, bool>(tag_type tag, std::vector<bool>& container, std::istream& data);
@@ -5,6 +5,7 @@
 #include "potions.h"
 #include "scrolls.h"
 #include "food.h"
+#include "gold.h"
 #include "weapons.h"
 #include "armor.h"
 #include "rings.h"
@@ -16,7 +17,7 @@
 using namespace std;
 
 template<>
-void Disk::save<Item>(tag_type tag, Item* element, std::ofstream& data) {
+void Disk::save<Item>(tag_type tag, Item* element, std::ostream& data) {
   save_tag(tag, data);
   if (element == nullptr) {
     save(tag, 0, data);
@@ -29,7 +30,7 @@ void Disk::save<Item>(tag_type tag, Item* element, std::ofstream& data) {
 }
 
 template<>
-bool Disk::load<Item>(tag_type tag, Item*& element, std::ifstream& data) {
+bool Disk::load<Item>(tag_type tag, Item*& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
 
   int null_checker;
@@ -50,6 +51,7 @@ bool Disk::load<Item>(tag_type tag, Item*& element, std::ifstream& data) {
     case IO::Armor:  element = new class Armor(data); break;
     case IO::Ring:   element = new class Ring(data); break;
     case IO::Wand:   element = new class Wand(data); break;
+    case IO::Gold:   element = new class Gold(data); break;
 
     default: error("Unknown item");
   }
@@ -2,14 +2,14 @@
 
 // std::string
 template <>
-void Disk::save<std::string>(tag_type tag, std::string const& element, std::ofstream& data) {
+void Disk::save<std::string>(tag_type tag, std::string const& element, std::ostream& data) {
   save_tag(tag, data);
   size_t element_size = element.size();
   data.write(reinterpret_cast<char const*>(&element_size), sizeof(element_size));
   data.write(element.c_str(), static_cast<long>(element_size));
 }
 template <>
-bool Disk::load<std::string>(tag_type tag, std::string& element, std::ifstream& data) {
+bool Disk::load<std::string>(tag_type tag, std::string& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
   size_t element_size;
   data.read(reinterpret_cast<char*>(&element_size), sizeof(element_size));
@@ -21,12 +21,12 @@ bool Disk::load<std::string>(tag_type tag, std::string& element, std::ifstream&
 
 // item
 template <>
-void Disk::save<Item>(tag_type tag, Item const& element, std::ofstream& data) {
+void Disk::save<Item>(tag_type tag, Item const& element, std::ostream& data) {
   save_tag(tag, data);
   element.save(data);
 }
 template <>
-bool Disk::load<Item>(tag_type tag, Item& element, std::ifstream& data) {
+bool Disk::load<Item>(tag_type tag, Item& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
   element.load(data);
   return true;
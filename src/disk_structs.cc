@@ -6,14 +6,14 @@ static_assert(sizeof(Daemons::Daemon) ==
     sizeof(Daemons::Daemon::func),
     "Daemons::Daemon size has changed");
 template<>
-void Disk::save<Daemons::Daemon>(tag_type tag, Daemons::Daemon const& element, std::ofstream& data) {
+void Disk::save<Daemons::Daemon>(tag_type tag, Daemons::Daemon const& element, std::ostream& data) {
   save_tag(tag, data);
 
   data.write(reinterpret_cast<char const*>(&element.type), sizeof(element.type));
   data.write(reinterpret_cast<char const*>(&element.func), sizeof(element.func));
 }
 template<>
-bool Disk::load<Daemons::Daemon>(tag_type tag, Daemons::Daemon& element, std::ifstream& data) {
+bool Disk::load<Daemons::Daemon>(tag_type tag, Daemons::Daemon& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
 
   data.read(reinterpret_cast<char*>(&element.type), sizeof(element.type));
@@ -28,7 +28,7 @@ static_assert(sizeof(Daemons::Fuse) ==
     sizeof(Daemons::Fuse::func),
     "Daemons::Func size has changed");
 template<>
-void Disk::save<Daemons::Fuse>(tag_type tag, Daemons::Fuse const& element, std::ofstream& data) {
+void Disk::save<Daemons::Fuse>(tag_type tag, Daemons::Fuse const& element, std::ostream& data) {
   save_tag(tag, data);
 
   data.write(reinterpret_cast<char const*>(&element.type), sizeof(element.type));
@@ -36,7 +36,7 @@ void Disk::save<Daemons::Fuse>(tag_type tag, Daemons::Fuse const& element, std::
   data.write(reinterpret_cast<char const*>(&element.time), sizeof(element.time));
 }
 template<>
-bool Disk::load<Daemons::Fuse>(tag_type tag, Daemons::Fuse& element, std::ifstream& data) {
+bool Disk::load<Daemons::Fuse>(tag_type tag, Daemons::Fuse& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
 
   data.read(reinterpret_cast<char*>(&element.type), sizeof(element.type));
@@ -51,13 +51,13 @@ static_assert(sizeof(Coordinate) ==
     sizeof(Coordinate::y),
     "Coordinate size has changed");
 template <>
-void Disk::save<Coordinate>(tag_type tag, Coordinate const& element, std::ofstream& data) {
+void Disk::save<Coordinate>(tag_type tag, Coordinate const& element, std::ostream& data) {
   save_tag(tag, data);
   data.write(reinterpret_cast<char const*>(&element.x), sizeof(element.x));
   data.write(reinterpret_cast<char const*>(&element.y), sizeof(element.y));
 }
 template <>
-bool Disk::load<Coordinate>(tag_type tag, Coordinate& element, std::ifstream& data) {
+bool Disk::load<Coordinate>(tag_type tag, Coordinate& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
   data.read(reinterpret_cast<char*>(&element.x), sizeof(element.x));
   data.read(reinterpret_cast<char*>(&element.y), sizeof(element.y));
@@ -70,13 +70,13 @@ static_assert(sizeof(damage) ==
     sizeof(damage::dices),
     "damage size has changed");
 template <>
-void Disk::save<damage>(tag_type tag, damage const& element, std::ofstream& data) {
+void Disk::save<damage>(tag_type tag, damage const& element, std::ostream& data) {
   save_tag(tag, data);
   data.write(reinterpret_cast<char const*>(&element.sides), sizeof(element.sides));
   data.write(reinterpret_cast<char const*>(&element.dices), sizeof(element.dices));
 }
 template <>
-bool Disk::load<damage>(tag_type tag, damage& element, std::ifstream& data) {
+bool Disk::load<damage>(tag_type tag, damage& element, std::istream& data) {
   if (!load_tag(tag, data)) { return false; }
   data.read(reinterpret_cast<char*>(&element.sides), sizeof(element.sides));
   data.read(reinterpret_cast<char*>(&element.dices), sizeof(element.dices));
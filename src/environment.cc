@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "command.h"
+#include "error_handling.h"
+#include "game.h"
+#include "io.h"
+#include "item.h"
+#include "level.h"
+#include "monster.h"
+#include "options.h"
+#include "os.h"
+#include "player.h"
+#include "rogue.h"
+#include "snapshot.h"
+
+#include "environment.h"
+
+using namespace std;
+
+static_assert(Environment::map_lines == NUMLINES && Environment::map_cols == NUMCOLS,
+              "Observation should cover the whole screen");
+
+static Game* game = nullptr;
+static Environment::Observation observation;
+
+static bool in_turn = false;              // command_turn_begin() has run
+static bool waiting_for_command = false;  // Turn is paused until step()
+static bool game_over = false;
+static int  deepest_level = 0;
+
+static int score() {
+  deepest_level = max(deepest_level, Game::current_level);
+  return player->get_gold() + player->get_experience() + 50 * deepest_level;
+}
+
+static void observe() {
+  memset(observation.tiles, 0, sizeof(observation.tiles));
+  memset(observation.things, 0, sizeof(observation.things));
+
+  // Same tiles as IO::refresh()
+  for (int x = 0; x < NUMCOLS -1; ++x) {
+    for (int y = 1; y < NUMLINES -1; ++y) {
+      if (Game::level->is_discovered(x, y) || Game::level->is_mapped(x, y)) {
+        observation.tiles[y][x] =
+          static_cast<unsigned char>(IO::tile_symbol(Game::level->get_tile(x, y)));
+      }
+    }
+  }
+
+  // Player::can_see() gives up past 2 tiles, so only look for what is in
+  // view around the player (see IO::discover_seen())
+  Coordinate const& pos = player->get_position();
+  for (int x = max(pos.x - 2, 0); x <= min(pos.x + 2, NUMCOLS -2); ++x) {
+    for (int y = max(pos.y - 2, 1); y <= min(pos.y + 2, NUMLINES -2); ++y) {
+      Coordinate coord(x, y);
+      if (!player->can_see(coord)) {
+        continue;
+      }
+
+      observation.tiles[y][x] =
+        static_cast<unsigned char>(IO::tile_symbol(Game::level->get_tile(coord))) |
+        Environment::in_view;
+
+      Monster* mon = Game::level->get_monster(coord);
+      if (mon != nullptr && (player->can_see(*mon) || player->can_sense_monsters())) {
+        observation.things[y][x] = static_cast<unsigned char>(mon->get_disguise());
+        continue;
+      }
+
+      Item* item = Game::level->get_item(coord);
+      if (item != nullptr) {
+        observation.things[y][x] = static_cast<unsigned char>(item->get_item_type());
+      }
+    }
+  }
+
+  observation.things[pos.y][pos.x] = static_cast<unsigned char>(player->get_type());
+  observation.x = pos.x;
+  observation.y = pos.y;
+
+  observation.depth        = Game::current_level;
+  observation.gold         = player->get_gold();
+  observation.health       = player->get_health();
+  observation.max_health   = player->get_max_health();
+  observation.strength     = player->get_strength();
+  observation.max_strength = player->get_default_strength();
+  observation.armor        = player->get_armor();
+  observation.level        = player->get_level();
+  observation.experience   = player->get_experience();
+  observation.nutrition    = player->get_nutrition_left();
+}
+
+// Does what command() does, but stops where it would read a command
+static void run_until_command() {
+  while (!waiting_for_command) {
+    if (!in_turn) {
+      command_turn_begin();
+      in_turn = true;
+    }
+
+    if (!command_player_due()) {
+      in_turn = false;
+      command_turn_end();
+
+    } else if (!command_move_begin()) {
+      command_move_end(true);
+
+    } else if (player->is_running() || to_death) {
+      command_move_end(command_do(runch));
+
+    } else {
+      waiting_for_command = true;
+    }
+  }
+}
+
+Environment::Observation const& Environment::reset(unsigned seed) {
+  close();
+
+  os_rand_seed = seed;
+  animation = Animation::Off;
+  Game::level_shape = Level::default_shape;
+  game = new Game(os_whoami(), "", true);
+  player->set_previous_room(Game::level->get_room_id(player->get_position()));
+
+  in_turn = false;
+  waiting_for_command = false;
+  game_over = false;
+  deepest_level = 0;
+  score();
+
+  try {
+    run_until_command();
+  } catch (Game::Result const&) {
+    game_over = true;
+  }
+
+  observe();
+  return observation;
+}
+
+Environment::Step Environment::step(char action) {
+  char const keys[] = { action, '\0' };
+  return step(keys);
+}
+
+Environment::Step Environment::step(char const* keys) {
+  if (game == nullptr || game_over) {
+    error("No game running, call reset() first");
+  } else if (keys[0] == '\0') {
+    error("No keys given to step()");
+  }
+
+  int const old_score = score();
+
+  Game::io->clear_message_batch();
+  io_feed_keys(keys + 1);
+  try {
+    waiting_for_command = false;
+    Game::io->clear_message();
+    command_move_end(command_do(keys[0]));
+    run_until_command();
+  } catch (Game::Result const&) {
+    game_over = true;
+  }
+  io_feed_keys(nullptr);
+
+  observe();
+  return { observation, score() - old_score, game_over };
+}
+
+int Environment::message_count() {
+  if (game == nullptr) {
+    error("No game running, call reset() first");
+  }
+  return static_cast<int>(Game::io->message_batch_size());
+}
+
+char const* Environment::message(int i) {
+  if (i < 0 || i >= message_count()) {
+    error("Message " + to_string(i) + " out of range");
+  }
+  return Game::io->message_batch_line(static_cast<size_t>(i));
+}
+
+class Environment::State {
+public:
+  Snapshot snapshot;
+  bool     in_turn;
+  bool     waiting_for_command;
+  bool     game_over;
+  int      deepest_level;
+};
+
+Environment::State* Environment::save_state() {
+  if (game == nullptr) {
+    error("No game running, call reset() first");
+  }
+  return new State { {}, in_turn, waiting_for_command, game_over, deepest_level };
+}
+
+Environment::Observation const& Environment::load_state(State const& state) {
+  if (game == nullptr) {
+    error("No game running, call reset() first");
+  }
+
+  state.snapshot.restore();
+  in_turn = state.in_turn;
+  waiting_for_command = state.waiting_for_command;
+  game_over = state.game_over;
+  deepest_level = state.deepest_level;
+
+  observe();
+  return observation;
+}
+
+void Environment::free_state(State* state) {
+  delete state;
+}
+
+void Environment::close() {
+  delete game;
+  game = nullptr;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+// Misty Mountains as an environment for reinforcement learning
+//
+// Build with `make libmisty_mountains.a` and link with it, -lcurses and -pthread.
+// The game runs headless: nothing is drawn, and every question the game asks
+// is answered with the keys given to step(), or escape when they run out.
+// Stepping does not allocate anything by itself, the observation is
+// overwritten in place. Maps always have the default size. Messages never
+// wait at --More--, they are collected for message() instead.
+namespace Environment {
+
+int constexpr map_lines = 24;
+int constexpr map_cols  = 80;
+
+// Set in Observation::tiles for tiles the player can see right now
+unsigned char constexpr in_view = 0x80;
+
+struct Observation {
+  // Indexed [y][x]. 0 if the player has not discovered the tile, else the
+  // symbol of the tile (see IO::Tile), or'ed with in_view
+  unsigned char tiles[map_lines][map_cols];
+
+  // Indexed [y][x]. Symbol of the player, and of the monsters and items
+  // on tiles in view. 0 if there's nothing there
+  unsigned char things[map_lines][map_cols];
+
+  // Same as the statusline, except that depth is the dungeon level
+  int depth;
+  int gold;
+  int health;
+  int max_health;
+  int strength;
+  int max_strength;
+  int armor;
+  int level;
+  int experience;
+  int nutrition;
+
+  // Player position
+  int x;
+  int y;
+};
+
+struct Step {
+  Observation const& observation;
+
+  // Gold and experience gained, plus 50 for each new deepest dungeon level
+  int  reward;
+
+  // The player died, quit or won. Call reset() to play again
+  bool done;
+};
+
+// Start a new game from seed. Ends any game already running
+Observation const& reset(unsigned seed);
+
+// Give a command, e.g. 'h' to move left. The game runs until it wants the next
+// command, so e.g. running or being asleep is a single step
+Step step(char action);
+
+// Like step(char), but keys after the first are answers for the command,
+// e.g. "qa" to quaff potion a. keys must not be empty
+Step step(char const* keys);
+
+// Lines of messages shown during the last reset() or step(), oldest first.
+// Valid until the next step()
+int message_count();
+char const* message(int i);
+
+// End the game and free everything
+void close();
+
+// A copy of the running game, for lookahead search
+class State;
+
+// Copy the running game
+State* save_state();
+
+// Go back to a copy. The same state can be loaded any number of times
+Observation const& load_state(State const& state);
+
+void free_state(State* state);
+
+}
@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -10,16 +11,21 @@
 #include "scrolls.h"
 #include "io.h"
 #include "armor.h"
+#include "broadcast.h"
 #include "daemons.h"
 #include "colors.h"
 #include "level.h"
 #include "rings.h"
 #include "misc.h"
 #include "player.h"
+#include "pregen.h"
+#include "profile.h"
 #include "weapons.h"
 #include "wand.h"
+#include "workers.h"
 #include "options.h"
 #include "rogue.h"
+#include "score.h"
 #include "traps.h"
 
 #include "Game.h"
@@ -31,8 +37,19 @@ IO*     Game::io = nullptr;
 Level*  Game::level = nullptr;
 string* Game::whoami = nullptr;
 string* Game::save_game_path = nullptr;
-int     Game::current_level = 1;
-int     Game::levels_without_food = 0;
+thread_local int Game::current_level = 1;
+thread_local int Game::levels_without_food = 0;
+int     Game::turns = 0;
+unsigned Game::next_level_seed = 0;
+Level::Shape Game::level_shape = Level::default_shape;
+int constexpr Game::save_version;
+
+void (*Game::score_sink)(Game::Result const&) = score_record;
+void (*Game::screen_sink)(Game::Result const&) = score_screen;
+
+void Game::end(Result::Ending ending, int cause) {
+  throw Result { ending, player->get_gold(), Game::current_level, cause, Game::turns };
+}
 
 void Game::exit() {
   if (game_ptr != nullptr) {
@@ -41,31 +58,53 @@ void Game::exit() {
   ::exit(0);
 }
 
+// What the level at dungeon_level will look like, given the game so far
+static Pregen::Inputs level_inputs(int dungeon_level) {
+  bool place_amulet = player != nullptr && !player->pack_contains_amulet();
+  return { dungeon_level, Game::next_level_seed, Game::levels_without_food,
+           place_amulet, Game::level_shape };
+}
+
 void Game::new_level(int dungeon_level) {
+  PROFILE_SCOPE(NewLevel);
 
   Game::current_level = dungeon_level;
 
-  if (Game::level != nullptr) {
-    delete Game::level;
-  }
+  // Usually the level is already built, so this only swaps them
+  Pregen::dispose(Game::level);
+  Game::level = Pregen::take(level_inputs(dungeon_level), Game::levels_without_food);
+
+  // Start on the next level down, while the player explores this one
+  Game::next_level_seed = static_cast<unsigned>(os_rand());
+  Pregen::start(level_inputs(dungeon_level + 1));
 
-  Game::level = new Level();
+  clear();
 
   // Drop player in the new dungeon level
   if (player == nullptr) {
     player = new Player(true);
+  } else {
+    player->set_previous_room(-1);
   }
 
   Coordinate new_player_pos = player->get_position();
-  Game::level->get_random_room_coord(nullptr, &new_player_pos, 0, true);
+  if (!Game::level->get_random_room_coord(nullptr, &new_player_pos, true)) {
+    error("No room for the player");
+  }
   player->set_position(new_player_pos);
   Game::io->print_color(new_player_pos.x, new_player_pos.y, player->get_type());
 
   // Unhold player just in case
   player->set_not_held();
+
+  if (player->has_ring_with_ability(Ring::AggravateMonsters)) {
+    for (Monster* monster : Game::level->monsters) {
+      monster_start_running(&monster->get_position());
+    }
+  }
 }
 
-int Game::run() {
+Game::Result Game::run() {
 
   // Try to crash cleanly, and autosave if possible
   // Unless we are debugging, since that messes with gdb/lldb
@@ -80,29 +119,34 @@ int Game::run() {
   signal(SIGSEGV, save_auto);
   signal(SIGSYS, save_auto);
   signal(SIGTERM, save_auto);
-  signal(SIGINT, command_signal_quit);
+  signal(SIGINT, command_signal_interrupt);
 #else
   Game::io->message("Seed: #" + to_string(starting_seed));
 #endif
 
-  player->set_previous_room(Game::level->get_room(player->get_position()));
+  player->set_previous_room(Game::level->get_room_id(player->get_position()));
 
-#ifdef NDEBUG
+  Result result {};
   try {
     for (;;) command();
-  } catch (const std::runtime_error &ex) {
-    endwin();
-    cout << ex.what() << endl;
-    return 1;
+  } catch (Result const& ending) {
+    result = ending;
   }
-#else
-  for (;;) command();
-#endif
 
-  // CODE NOT REACHED
+  // The screen sink reads keys too, and a replay can run out there
+  try {
+    if (score_sink != nullptr) {
+      score_sink(result);
+    }
+    if (screen_sink != nullptr) {
+      screen_sink(result);
+    }
+  } catch (Result const&) {
+  }
+  return result;
 }
 
-Game::Game(string const& whoami_, string const& save_path_)
+Game::Game(string const& whoami_, string const& save_path_, bool headless)
   : starting_seed(os_rand_seed) {
     Game::whoami = new string(whoami_);
     Game::save_game_path = new string(save_path_);
@@ -111,10 +155,12 @@ Game::Game(string const& whoami_, string const& save_path_)
     error("Game is a singleton class");
   }
   game_ptr = this;
-  cout << "Hello " << *whoami << ", just a moment while I dig the dungeon..." << flush;
+  if (!headless) {
+    cout << "Hello " << *whoami << ", just a moment while I dig the dungeon..." << flush;
+  }
 
   // Init stuff
-  Game::io = new IO();                  // Graphics
+  Game::io = new IO(headless);          // Graphics
   Scroll::init_scrolls();               // Names of scrolls
   Color::init_colors();                 // Colors for potions and stuff
   Potion::init_potions();               // Colors of potions
@@ -123,6 +169,7 @@ Game::Game(string const& whoami_, string const& save_path_)
   Daemons::init_daemons();              // Over-time-effects
   Monster::init_monsters();             // Monster types
   Trap::init_traps();                   // Trap types
+  Game::next_level_seed = static_cast<unsigned>(os_rand());
   Game::new_level(Game::current_level); // Level (and player)
 
   // Start up daemons and fuses
@@ -132,24 +179,46 @@ Game::Game(string const& whoami_, string const& save_path_)
 }
 
 Game::~Game() {
+  Broadcast::stop();
+  Pregen::stop();
+  Workers::stop();
+  free_state();
+  Color::free_colors();
+
+  delete Game::io;
+  Game::io = nullptr;
+
+  // Leave things as they were, in case someone wants to start a new game
+  Game::current_level = 1;
+  Game::levels_without_food = 0;
+  Game::turns = 0;
+  game_ptr = nullptr;
+}
+
+void Game::free_state() {
   Trap::free_traps();
   Monster::free_monsters();
   Daemons::free_daemons();
   Wand::free_wands();
   Ring::free_rings();
   Potion::free_potions();
-  Color::free_colors();
   Scroll::free_scrolls();
 
-  delete Game::io;
-  Game::io = nullptr;
+  delete Game::level;
+  Game::level = nullptr;
+
+  delete player;
+  player = nullptr;
 
   delete Game::whoami;
   Game::whoami = nullptr;
+
+  delete Game::save_game_path;
+  Game::save_game_path = nullptr;
 }
 
 
-Game::Game(ifstream& savefile) {
+Game::Game(istream& savefile) {
 
   if (game_ptr != nullptr) {
     error("Game is a singleton class");
@@ -157,25 +226,76 @@ Game::Game(ifstream& savefile) {
   game_ptr = this;
 
   Game::io = new IO();
-  Scroll::load_scrolls(savefile);
   Color::init_colors();
-  Potion::load_potions(savefile);
-  Ring::load_rings(savefile);
-  Wand::load_wands(savefile);
-  Daemons::load_daemons(savefile);
+  load_state(savefile);
+  starting_seed = os_rand_seed;
+
+  // The level below is not saved, but its seed is
+  Pregen::start(level_inputs(Game::current_level + 1));
+}
+
+void Game::load_state(istream& data) {
+  // Savefiles from before there was a version start with the scrolls
+  int file_version = 0;
+  if (!Disk::load(TAG_VERSION, file_version, data)) {
+    error("Savefile is from an older version of the game");
+  } else if (file_version != save_version) {
+    error("Savefile is version " + to_string(file_version) +
+          ", but this game reads version " + to_string(save_version));
+  }
+
+  Scroll::load_scrolls(data);
+  Potion::load_potions(data);
+  Ring::load_rings(data);
+  Wand::load_wands(data);
+  Daemons::load_daemons(data);
   Monster::init_monsters();
   Trap::init_traps();
-  Player::load_player(savefile);
-
-  Disk::load_tag(TAG_GAME, savefile);
-  Disk::load(TAG_WHOAMI, Game::whoami, savefile);
-  Disk::load(TAG_SAVEPATH, Game::save_game_path, savefile);
-  Disk::load(TAG_LEVEL, Game::current_level, savefile);
-  Disk::load(TAG_FOODLESS, Game::levels_without_food, savefile);
+  Player::load_player(data);
+
+  if (!Disk::load_tag(TAG_GAME, data) ||
+      !Disk::load(TAG_WHOAMI, Game::whoami, data) ||
+      !Disk::load(TAG_SAVEPATH, Game::save_game_path, data) ||
+      !Disk::load(TAG_LEVEL, Game::current_level, data) ||
+      !Disk::load(TAG_FOODLESS, Game::levels_without_food, data) ||
+      !Disk::load(TAG_TURNS, Game::turns, data) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.width, data) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.height, data) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.room_columns, data) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.room_rows, data) ||
+      !Disk::load(TAG_SEEDS, os_rand_seed, data) ||
+      !Disk::load(TAG_SEEDS, Game::next_level_seed, data) ||
+      !Disk::load(TAG_FLYTRAP, monster_flytrap_hit, data)) {
+    error("Game tag error");
+  }
 
+  Game::level = new Level(data);
+}
 
-  //Game::new_level(Game::current_level);
-  Game::new_level(1);
+void Game::save_state(ostream& data) {
+  Disk::save(TAG_VERSION, save_version, data);
+  Scroll::save_scrolls(data);
+  Potion::save_potions(data);
+  Ring::save_rings(data);
+  Wand::save_wands(data);
+  Daemons::save_daemons(data);
+  Player::save_player(data);
+
+  Disk::save_tag(TAG_GAME, data);
+  Disk::save(TAG_WHOAMI, Game::whoami, data);
+  Disk::save(TAG_SAVEPATH, Game::save_game_path, data);
+  Disk::save(TAG_LEVEL, Game::current_level, data);
+  Disk::save(TAG_FOODLESS, Game::levels_without_food, data);
+  Disk::save(TAG_TURNS, Game::turns, data);
+  Disk::save(TAG_SHAPE, Game::level_shape.width, data);
+  Disk::save(TAG_SHAPE, Game::level_shape.height, data);
+  Disk::save(TAG_SHAPE, Game::level_shape.room_columns, data);
+  Disk::save(TAG_SHAPE, Game::level_shape.room_rows, data);
+  Disk::save(TAG_SEEDS, os_rand_seed, data);
+  Disk::save(TAG_SEEDS, Game::next_level_seed, data);
+  Disk::save(TAG_FLYTRAP, monster_flytrap_hit, data);
+
+  Game::level->save(data);
 }
 
 bool Game::save() {
@@ -185,19 +305,46 @@ bool Game::save() {
     return false;
   }
 
-  Scroll::save_scrolls(savefile);
-  Potion::save_potions(savefile);
-  Ring::save_rings(savefile);
-  Wand::save_wands(savefile);
-  Daemons::save_daemons(savefile);
-  Player::save_player(savefile);
+  save_state(savefile);
+  savefile.close();
+  return true;
+}
 
-  Disk::save_tag(TAG_GAME, savefile);
-  Disk::save(TAG_WHOAMI, Game::whoami, savefile);
-  Disk::save(TAG_SAVEPATH, Game::save_game_path, savefile);
-  Disk::save(TAG_LEVEL, Game::current_level, savefile);
-  Disk::save(TAG_FOODLESS, Game::levels_without_food, savefile);
+// Where a hibernating game is. Set while it sleeps
+static string hibernation_path;
 
-  savefile.close();
+bool Game::hibernate() {
+  string const path = *save_game_path + ".hibernate";
+  ofstream file(path, fstream::out | fstream::trunc | fstream::binary);
+  if (!file) {
+    return false;
+  }
+  save_state(file);
+  file.close();
+  if (!file) {
+    remove(path.c_str());
+    return false;
+  }
+
+  // The level being built below is the biggest thing after the level itself
+  Pregen::stop();
+  Workers::stop();
+  free_state();
+  os_release_memory();
+  hibernation_path = path;
   return true;
 }
+
+void Game::wake() {
+  ifstream file(hibernation_path, fstream::in | fstream::binary);
+  if (!file) {
+    error("Failed to wake up from " + hibernation_path);
+  }
+  load_state(file);
+  file.close();
+  remove(hibernation_path.c_str());
+  hibernation_path.clear();
+
+  Pregen::start(level_inputs(Game::current_level + 1));
+  player->set_previous_room(Game::level->get_room_id(player->get_position()));
+}
@@ -8,35 +8,86 @@
 
 class Game {
 public:
-  Game(std::string const& whoami, std::string const& save_path);
-  Game(std::ifstream& savefile);
+  Game(std::string const& whoami, std::string const& save_path, bool headless=false);
+  Game(std::istream& savefile);
   Game(Game const&) = delete;
 
   ~Game();
 
   Game& operator=(Game const&) = delete;
 
-  int  run();
+  // How a game ended
+  struct Result {
+    enum Ending {  // Same numbers as the highscore flags
+      Killed           = 0,
+      Quit             = 1,
+      Won              = 2,
+      KilledWithAmulet = 3,
+      Saved            = 4,
+      Stopped          = 5,  // Left without saving, like when a replay runs out
+    };
 
+    Ending ending;
+    int    score;  // Gold
+    int    depth;  // Dungeon level
+    int    cause;  // What killed the player, see death_reason()
+    int    turns;
+  };
+
+  // Play until the game ends. Calls the sinks with the result and returns it
+  Result run();
+
+  // Where results go when a game ends. Either can be nullptr
+  static void (*score_sink)(Result const&);   // Default: record highscore
+  static void (*screen_sink)(Result const&);  // Default: show highscores
+
+  // End the game, see run()
+  static void end(Result::Ending ending, int cause=0) __attribute__((noreturn));
+
+  // Exit the program right away. Only for signal handlers, anything else
+  // ends the game with end() so run() returns
   static void exit() __attribute__((noreturn));
   static void new_level(int dungeon_level);
   static bool save();
 
+  // Idle games can write themselves to disk and free the memory they use,
+  // see --hibernate. hibernate() returns false (and changes nothing) if the
+  // game could not be written, else wake() must be called before anything
+  // else touches the game
+  static bool hibernate();
+  static void wake();
+
   static IO*           io;
   static Level*        level;
   static std::string*  whoami;
   static std::string*  save_game_path;
-  static int           current_level;
+  static thread_local int current_level;        // Own copy when building levels
   static int constexpr amulet_min_level = 26;
-  static int           levels_without_food;
+  static thread_local int levels_without_food;  // Own copy when building levels
+  static int           turns;
+  static unsigned      next_level_seed;          // Forked from os_rand_seed
+  static Level::Shape  level_shape;              // Shape of new levels
 
 private:
+  // Everything save() writes, which is all but the screen
+  static void save_state(std::ostream& data);
+  static void load_state(std::istream& data);
+  static void free_state();
+
   static Game* game_ptr;
   unsigned     starting_seed;
 
+  // Change when save_state() does, so older savefiles are turned away
+  static int constexpr save_version = 1;
+
   static unsigned long long constexpr TAG_GAME      = 0x6000000000000000ULL;
   static unsigned long long constexpr TAG_WHOAMI    = 0x6000000000000001ULL;
   static unsigned long long constexpr TAG_SAVEPATH  = 0x6000000000000002ULL;
   static unsigned long long constexpr TAG_LEVEL     = 0x6000000000000003ULL;
   static unsigned long long constexpr TAG_FOODLESS  = 0x6000000000000004ULL;
+  static unsigned long long constexpr TAG_TURNS     = 0x6000000000000005ULL;
+  static unsigned long long constexpr TAG_SHAPE     = 0x6000000000000006ULL;
+  static unsigned long long constexpr TAG_SEEDS     = 0x6000000000000007ULL;
+  static unsigned long long constexpr TAG_FLYTRAP   = 0x6000000000000008ULL;
+  static unsigned long long constexpr TAG_VERSION   = 0x6000000000000009ULL;
 };
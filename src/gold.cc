@@ -1,5 +1,6 @@
 #include <string>
 
+#include "disk.h"
 #include "error_handling.h"
 #include "os.h"
 #include "game.h"
@@ -16,6 +17,23 @@ Gold::Gold(int amount_) : Item(), amount(amount_) {
   o_type = IO::Gold;
 }
 
+Gold::Gold(std::istream& data) : Item(), amount(0) {
+  load(data);
+}
+
+void Gold::save(std::ostream& data) const {
+  Item::save(data);
+  Disk::save(TAG_GOLD, amount, data);
+}
+
+bool Gold::load(std::istream& data) {
+  if (!Item::load(data) ||
+      !Disk::load(TAG_GOLD, amount, data)) {
+    return false;
+  }
+  return true;
+}
+
 int Gold::get_amount() const {
   return amount;
 }
@@ -11,6 +11,7 @@ public:
   explicit Gold();
   explicit Gold(int amount);
   explicit Gold(Gold const&) = default;
+  explicit Gold(std::istream&);
 
   Gold* clone() const override;
   Gold& operator=(Gold const&) = default;
@@ -28,10 +29,15 @@ public:
   int         get_base_value() const override;
   bool        is_stackable() const override;
 
+  virtual void save(std::ostream&) const override;
+  virtual bool load(std::istream&) override;
+
   // static
   static int random_gold_amount();
 
 private:
   int amount;
+
+  static unsigned long long constexpr TAG_GOLD      = 0xa000000000000001ULL;
 };
 
@@ -1,4 +1,4 @@
-#include <sstream>
+#include <algorithm>
 #include <string>
 
 #include <ctype.h>
@@ -13,6 +13,7 @@
 #include "error_handling.h"
 #include "game.h"
 #include "armor.h"
+#include "broadcast.h"
 #include "command.h"
 #include "food.h"
 #include "level.h"
@@ -20,23 +21,44 @@
 #include "options.h"
 #include "os.h"
 #include "player.h"
+#include "profile.h"
+#include "ray.h"
+#include "replay.h"
 #include "rogue.h"
+#include "server.h"
+#include "travel.h"
 
 #include "io.h"
 
 using namespace std;
 
-IO::IO() : last_messages(), message_buffer(), extra_screen(nullptr) {
-  initscr();  // Start up cursor package
+IO::IO(bool headless_)
+  : last_messages(static_cast<size_t>(message_history), NUMCOLS),
+    message_buffer(), extra_screen(nullptr),
+    headless(headless_), batch(headless_ || batch_messages), batched_lines(0),
+    null_device(nullptr), screen(nullptr), camera(0, 0),
+    glyph_colors() {
+
+  if (headless) {
+    // Nobody is watching, so draw on a standard terminal which goes nowhere
+    null_device = fopen("/dev/null", "r+");
+    if (null_device == nullptr) {
+      error("Failed to open /dev/null");
+    }
+    screen = newterm("vt100", null_device, null_device);
+    if (screen == nullptr) {
+      error("Failed to start headless terminal");
+    }
+
+  } else {
+    initscr();  // Start up cursor package
+  }
 
   // Ncurses colors
-  if (use_colors) {
+  if (use_colors && !headless) {
     if (start_color() == ERR) {
       endwin();
-      cerr
-        << "Error: Failed to start colors. "
-        << "Try restarting without colors enabled\n";
-      Game::exit();
+      error("Failed to start colors. Try restarting without colors enabled");
     }
 
     // Because ncurses has defined COLOR_BLACK to 0 and COLOR_WHITE to 7,
@@ -55,20 +77,120 @@ IO::IO() : last_messages(), message_buffer(), extra_screen(nullptr) {
 
   if (LINES < NUMLINES || COLS < NUMCOLS) {
     endwin();
-    cerr << "\nSorry, the screen must be at least "
-         << NUMLINES << "x" << NUMCOLS << "\n";
-    Game::exit();
+    error("Sorry, the screen must be at least " +
+          to_string(NUMLINES) + "x" + to_string(NUMCOLS));
   }
 
   raw();     // Raw mode
   noecho();  // Echo off
 
+  init_glyph_colors();
+
+  // Room for any message line, so message() does not have to grow it
+  message_buffer.reserve(MAXSTR);
+
   extra_screen = newwin(LINES, COLS, 0, 0);
 }
 
 IO::~IO() {
   delwin(extra_screen);
   endwin();
+
+  if (screen != nullptr) {
+    delscreen(screen);
+  }
+  if (null_device != nullptr) {
+    fclose(null_device);
+  }
+}
+
+bool IO::is_headless() const {
+  return headless;
+}
+
+bool IO::batches_messages() const {
+  return batch;
+}
+
+size_t IO::message_batch_size() const {
+  return min(batched_lines, last_messages.size());
+}
+
+char const* IO::message_batch_line(size_t i) const {
+  return last_messages.at(message_batch_size() - 1 - i);
+}
+
+void IO::clear_message_batch() {
+  batched_lines = 0;
+}
+
+Coordinate const& IO::get_camera() const {
+  return camera;
+}
+
+void IO::draw(int x, int y, chtype ch, IO::Attribute attr) {
+  if (x < 0 || x >= Game::level->get_width() ||
+      y < 0 || y >= Game::level->get_height()) {
+    error("Attempted to print beyond map! X: " +
+          to_string(x) + ", Y: " + to_string(y));
+  }
+
+  // First and last line are for text
+  int const screen_x = x - camera.x;
+  int const screen_y = y - camera.y;
+  if (screen_y < 1 || screen_y >= NUMLINES -1 ||
+      screen_x < 0 || screen_x >= NUMCOLS) {
+    return;
+  }
+
+  switch (attr) {
+    case IO::Attribute::None: break;
+    case IO::Attribute::Standout: ch |= A_STANDOUT; break;
+    case IO::Attribute::Red: ch |= COLOR_PAIR(COLOR_RED); break;
+    case IO::Attribute::Blue: ch |= COLOR_PAIR(COLOR_BLUE); break;
+  }
+  mvaddch(screen_y, screen_x, ch);
+}
+
+void IO::print_extra(int x, int y, chtype ch) {
+  int const screen_x = x - camera.x;
+  int const screen_y = y - camera.y;
+  if (screen_y < 1 || screen_y >= NUMLINES -1 ||
+      screen_x < 0 || screen_x >= NUMCOLS) {
+    return;
+  }
+  mvwaddch(extra_screen, screen_y, screen_x, colorize(ch));
+}
+
+void IO::update_camera() {
+  Level const& level = *Game::level;
+  Coordinate const& pos = player->get_position();
+
+  // What refresh() draws, and how close the player may get to its edges
+  int const view_width = NUMCOLS -1;
+  int const view_height = NUMLINES -2;
+  int const margin_x = view_width / 4;
+  int const margin_y = view_height / 4;
+
+  // The last column and row of the map are never dug out, so no need to show them
+  Coordinate new_camera = camera;
+  if (pos.x < camera.x + margin_x || pos.x >= camera.x + view_width - margin_x) {
+    new_camera.x = max(0, min(pos.x - view_width / 2, level.get_width() - NUMCOLS));
+  }
+  if (pos.y < camera.y + 1 + margin_y || pos.y > camera.y + view_height - margin_y) {
+    new_camera.y = max(0, min(pos.y - 1 - view_height / 2, level.get_height() - NUMLINES));
+  }
+
+  if (new_camera == camera) {
+    return;
+  }
+
+  // Everything on screen is somewhere else now
+  camera = new_camera;
+  for (int y = 1; y < NUMLINES -1; ++y) {
+    move(y, 0);
+    clrtoeol();
+  }
 }
 
 
@@ -84,66 +206,67 @@ void IO::print_item(Item* item) {
   print_color(coord.x, coord.y, symbol_to_print);
 }
 
-void IO::print_tile_seen(Coordinate const& coord) {
+chtype IO::render_tile_seen(Coordinate const& coord) {
   Game::level->set_discovered(coord);
 
   // Next prio: Player
   if (player->get_position() == coord) {
-    print_color(coord.x, coord.y, player->get_type());
-    return;
+    return colorize(static_cast<chtype>(player->get_type()));
   }
 
   // Next prio: Monsters
   Monster* mon = Game::level->get_monster(coord);
   if (mon != nullptr) {
+    chtype monster = colorize(static_cast<chtype>(mon->get_disguise()));
     if (player->can_see(*mon)) {
-      print_monster(mon);
-      return;
+      return monster;
 
     } else if (player->can_sense_monsters()) {
-      standout();
-      print_monster(mon);
-      standend();
-      return;
+      return monster | A_STANDOUT;
     }
   }
 
   // Next prio: Items
   Item* item = Game::level->get_item(coord);
   if (item != nullptr) {
-    print_item(item);
-    return;
+    return colorize(static_cast<chtype>(item->get_item_type()));
   }
 
   // Next prio: Floor
-  print_color(coord.x, coord.y, Game::level->get_tile(coord));
+  return colorize(static_cast<chtype>(tile_symbol(Game::level->get_tile(coord))));
 }
 
-void IO::print_tile_discovered(Coordinate const& coord) {
+chtype IO::render_tile_discovered(Coordinate const& coord) {
 
   // Next prio: Floor
   ::Tile::Type tile = Game::level->get_tile(coord);
   if (tile == ::Tile::Floor) {
-    print_color(coord.x, coord.y, IO::Shadow);
+    return colorize(IO::Shadow);
   } else {
-    print_color(coord.x, coord.y, tile);
+    return colorize(static_cast<chtype>(tile_symbol(tile)));
   }
+}
+
+chtype IO::render_tile(Coordinate const& coord) {
+  if (player->can_see(coord)) {
+    return render_tile_seen(coord);
 
+  } else if (Game::level->is_discovered(coord) || Game::level->is_mapped(coord)) {
+    return render_tile_discovered(coord);
+  }
+
+  return 0;
 }
 
 void IO::print_tile(Coordinate const& coord) {
-  print_tile(coord.x, coord.y);
+  chtype ch = render_tile(coord);
+  if (ch != 0) {
+    print(coord.x, coord.y, ch);
+  }
 }
 
 void IO::print_tile(int x, int y) {
-  Coordinate coord(x, y);
-
-  if (player->can_see(coord)) {
-    print_tile_seen(coord);
-
-  } else if (Game::level->is_discovered(coord)) {
-    print_tile_discovered(coord);
-  }
+  print_tile(Coordinate(x, y));
 }
 
 void IO::hide_tile(Coordinate const& coord) {
@@ -154,48 +277,56 @@ void IO::hide_tile(int x, int y) {
   print(x, y, IO::Shadow);
 }
 
-chtype IO::colorize(chtype ch)
-{
-  if (!use_colors)
-    return ch;
-
-  // NOTE: COLOR_WHITE is black and COLOR_BLACK is white, because reasons
-
-  switch (ch)
-  {
-    // Dungeon
-    case IO::ClosedDoor:
-    case IO::Wall: return ch | COLOR_PAIR(COLOR_WHITE) | A_BOLD;
-    case IO::Trap: return ch | COLOR_PAIR(COLOR_RED);
-
-    case IO::Floor:
-    case IO::OpenDoor:
-    case IO::Stairs: return ch | COLOR_PAIR(COLOR_YELLOW);
+chtype IO::colorize(chtype ch) {
+  if (ch < glyph_colors_size) {
+    return ch | glyph_colors[ch];
+  }
+  return use_colors ? ch | COLOR_PAIR(COLOR_BLACK) : ch;
+}
 
-    // Items
-    case IO::Gold: return ch | COLOR_PAIR(COLOR_YELLOW) | A_BOLD;
+void IO::init_glyph_colors() {
+  if (!use_colors) {
+    for (chtype& color : glyph_colors) {
+      color = 0;
+    }
+    return;
+  }
 
-    // Monsters
-    case 'b': return ch | COLOR_PAIR(COLOR_WHITE) | A_BOLD;
-    case 'g': return ch | COLOR_PAIR(COLOR_YELLOW);
-    case 'h': return ch | COLOR_PAIR(COLOR_GREEN);
-    case 'i': return ch | COLOR_PAIR(COLOR_CYAN);
-    case 'k': return ch | COLOR_PAIR(COLOR_YELLOW) | A_BOLD;
-    case 'l': return ch | COLOR_PAIR(COLOR_GREEN) | A_BOLD;
-    case 'n': return ch | COLOR_PAIR(COLOR_GREEN) | A_BOLD;
-    case 'r': return ch | COLOR_PAIR(COLOR_RED);
-    case 's': return ch | COLOR_PAIR(COLOR_GREEN);
+  for (chtype& color : glyph_colors) {
+    color = COLOR_PAIR(COLOR_BLACK);
+  }
 
+  // NOTE: COLOR_WHITE is black and COLOR_BLACK is white, because reasons
 
-    default: return ch | COLOR_PAIR(COLOR_BLACK);
-  }
+  // Dungeon
+  glyph_colors[IO::ClosedDoor] = COLOR_PAIR(COLOR_WHITE) | A_BOLD;
+  glyph_colors[IO::Wall]       = COLOR_PAIR(COLOR_WHITE) | A_BOLD;
+  glyph_colors[IO::Trap]       = COLOR_PAIR(COLOR_RED);
+
+  glyph_colors[IO::Floor]      = COLOR_PAIR(COLOR_YELLOW);
+  glyph_colors[IO::OpenDoor]   = COLOR_PAIR(COLOR_YELLOW);
+  glyph_colors[IO::Stairs]     = COLOR_PAIR(COLOR_YELLOW);
+
+  // Items
+  glyph_colors[IO::Gold]       = COLOR_PAIR(COLOR_YELLOW) | A_BOLD;
+
+  // Monsters
+  glyph_colors['b'] = COLOR_PAIR(COLOR_WHITE) | A_BOLD;
+  glyph_colors['g'] = COLOR_PAIR(COLOR_YELLOW);
+  glyph_colors['h'] = COLOR_PAIR(COLOR_GREEN);
+  glyph_colors['i'] = COLOR_PAIR(COLOR_CYAN);
+  glyph_colors['k'] = COLOR_PAIR(COLOR_YELLOW) | A_BOLD;
+  glyph_colors['l'] = COLOR_PAIR(COLOR_GREEN) | A_BOLD;
+  glyph_colors['n'] = COLOR_PAIR(COLOR_GREEN) | A_BOLD;
+  glyph_colors['r'] = COLOR_PAIR(COLOR_RED);
+  glyph_colors['s'] = COLOR_PAIR(COLOR_GREEN);
 }
 
 void IO::print_player_vision() {
 
   Coordinate const& player_pos = player->get_position();
-  if (player_pos.x < 1 || player_pos.x >= NUMCOLS -1 ||
-      player_pos.y < 1 || player_pos.y >= NUMLINES -1) {
+  if (player_pos.x < 1 || player_pos.x >= Game::level->get_width() -1 ||
+      player_pos.y < 1 || player_pos.y >= Game::level->get_height() -1) {
     error("player_pos is too close to the edge");
   }
 
@@ -215,8 +346,8 @@ void IO::print_player_vision() {
 
 void IO::print_level_layout() {
   /* take all the things we want to keep hidden out of the window */
-  for (int y = 1; y < NUMLINES - 1; y++) {
-    for (int x = 0; x < NUMCOLS; x++) {
+  for (int y = 1; y < Game::level->get_height() - 1; y++) {
+    for (int x = 0; x < Game::level->get_width(); x++) {
 
       ::Tile::Type ch = Game::level->get_tile(x, y);
       switch (ch) {
@@ -249,6 +380,10 @@ void IO::print_level_layout() {
         case ::Tile::Trap: break;
       }
 
+      // Remembered so it's drawn again when the camera comes back. It is not
+      // discovered by this, only floors and traps are, like they always were
+      Game::level->set_mapped(x, y);
+
       Monster* obj = Game::level->get_monster(x, y);
       if (obj == nullptr || !player->can_sense_monsters()) {
         print_color(x, y, ch);
@@ -259,16 +394,54 @@ void IO::print_level_layout() {
   }
 }
 
+void IO::discover_seen() {
+  // Player::can_see() gives up past 2 tiles. Only what the camera sees
+  // counts, like when it's drawn
+  Coordinate const& pos = player->get_position();
+  for (int y = max(pos.y - 2, camera.y + 1); y <= min(pos.y + 2, camera.y + NUMLINES - 2); ++y) {
+    for (int x = max(pos.x - 2, camera.x); x <= min(pos.x + 2, camera.x + NUMCOLS - 2); ++x) {
+      if (player->can_see(Coordinate(x, y))) {
+        Game::level->set_discovered(x, y);
+      }
+    }
+  }
+}
+
 void IO::refresh() {
-  for (int x = 0; x < NUMCOLS -1; ++x) {
-    for (int y = 1; y < NUMLINES -1; ++y) {
-      print_tile(x, y);
+  PROFILE_SCOPE(Refresh);
+  update_camera();
+
+  // Nobody looks at a headless screen, but drawing is what discovers tiles
+  if (headless) {
+    discover_seen();
+    return;
+  }
+
+  // Draw a row at a time. Tiles we know nothing about keep what's on screen.
+  // Only what the camera sees is drawn, so this costs the same on any map
+  chtype row[NUMCOLS];
+  for (int y = 1; y < NUMLINES -1; ++y) {
+    mvinchnstr(y, 0, row, NUMCOLS -1);
+    for (int x = 0; x < NUMCOLS -1; ++x) {
+      chtype ch = render_tile(Coordinate(x + camera.x, y + camera.y));
+      if (ch != 0) {
+        row[x] = ch;
+      }
     }
+    mvaddchnstr(y, 0, row, NUMCOLS -1);
   }
 
   refresh_statusline();
-  move(player->get_position().y, player->get_position().x);
-  ::refresh();
+  move(player->get_position().y - camera.y, player->get_position().x - camera.x);
+
+  // Without animations, running is only shown when it's done. Travelling
+  // and repeating a command always are, since they go on much longer
+  if (!(player->is_running() &&
+                     (animation == Animation::Off || Travel::in_progress() ||
+                      command_repeating()))) {
+    ::refresh();
+    Broadcast::publish();
+  }
 }
 
 void IO::refresh_statusline() {
@@ -296,14 +469,19 @@ void IO::refresh_statusline() {
 }
 
 void IO::repeat_last_messages() {
-  wclear(extra_screen);
-  wmove(extra_screen, 1, 0);
-  for (string const& msg : last_messages) {
-    waddch(extra_screen, '>');
-    waddstr(extra_screen, msg.c_str());
-    waddch(extra_screen, '\n');
-  }
-  show_extra_screen("Previous Messages: (press SPACE to return)");
+  // A page at a time, newest first
+  size_t const page_size = NUMLINES - 1;
+  size_t line = 0;
+  do {
+    wclear(extra_screen);
+    for (size_t row = 1; row <= page_size && line < last_messages.size(); ++row, ++line) {
+      mvwaddch(extra_screen, static_cast<int>(row), 0, '>');
+      waddnstr(extra_screen, last_messages.at(line), NUMCOLS - 1);
+    }
+    show_extra_screen(line < last_messages.size()
+        ? "Previous Messages: (press SPACE for more)"
+        : "Previous Messages: (press SPACE to return)");
+  } while (line < last_messages.size());
 }
 
 string IO::read_string(WINDOW* win, string const* initial_string) {
@@ -392,7 +570,8 @@ void IO::show_extra_screen(string const& message)
   wmove(extra_screen, 0, 0);
   waddstr(extra_screen, message.c_str());
   touchwin(extra_screen);
-  wmove(extra_screen, player->get_position().y, player->get_position().x);
+  wmove(extra_screen, player->get_position().y - camera.y,
+        player->get_position().x - camera.x);
   wrefresh(extra_screen);
   untouchwin(stdscr);
 
@@ -405,51 +584,54 @@ void IO::show_extra_screen(string const& message)
 
 void IO::message(string const& message, bool force_flush) {
 
-  string const more_string = " --More--";
-  size_t max_message = static_cast<size_t>(NUMCOLS) - more_string.size();
+  static char const more_string[] = " --More--";
+  size_t const max_message = static_cast<size_t>(NUMCOLS) - (sizeof(more_string) - 1);
 
-  // Pause when beginning on new line
+  // Pause when beginning on new line, unless we are batching. Then the line
+  // is already in last_messages, so we just start a new one
   if (!message_buffer.empty() &&
       (message_buffer.size() + message.size() > max_message ||
       force_flush)) {
-    message_buffer += more_string;
 
-    mvaddstr(0, 0, message_buffer.c_str());
-    clrtoeol();
-    move(0, static_cast<int>(message_buffer.size()));
-    ::refresh();
-    int ch = getch();
-    while (ch != KEY_SPACE && ch != '\n' && ch != '\r' && ch != KEY_ESCAPE) {
-      ch = getch();
+    if (!batch) {
+      message_buffer += more_string;
+
+      mvaddstr(0, 0, message_buffer.c_str());
+      clrtoeol();
+      move(0, static_cast<int>(message_buffer.size()));
+      ::refresh();
+      int ch = io_getch();
+      while (ch != KEY_SPACE && ch != '\n' && ch != '\r' && ch != KEY_ESCAPE) {
+        ch = io_getch();
+      }
     }
 
     message_buffer.clear();
   }
 
-  stringstream os;
-  os << message_buffer;
-  if (!message_buffer.empty()) {
-    os << ". ";
+  // Formatted in place, message_buffer keeps its capacity between messages
+  bool const continued = !message_buffer.empty();
+  if (continued) {
+    message_buffer += ". ";
   }
 
-  if (message.size() > 1) {
-    os
-      << static_cast<char>(toupper(message.at(0)))
-      << message.substr(1);
-  } else if (message.size() > 0) {
-    os << string(1, static_cast<char>(toupper(message.at(0))));
-  }
+  if (!message.empty()) {
+    message_buffer += static_cast<char>(toupper(message.at(0)));
+    message_buffer.append(message, 1, string::npos);
 
-  if (message.back() == '?') {
-    os << " ";
+    if (message.back() == '?') {
+      message_buffer += ' ';
+    }
   }
 
-  message_buffer = os.str();
   mvaddstr(0, 0, message_buffer.c_str());
 
-  last_messages.push_front(message_buffer);
-  if (last_messages.size() > 20) {
-    last_messages.pop_back();
+  // A line that grew is still one line in the log
+  if (continued) {
+    last_messages.replace_newest(message_buffer);
+  } else {
+    last_messages.push(message_buffer);
+    ++batched_lines;
   }
 
   clrtoeol();
@@ -493,6 +675,54 @@ io_debug_fatal(char const* fmt, ...)
 
 #endif
 
+static char const* fed_keys = nullptr;
+
+void
+io_feed_keys(char const* keys)
+{
+  fed_keys = keys;
+}
+
+int
+io_getch()
+{
+  if (Game::io != nullptr && Game::io->is_headless()) {
+    if (fed_keys == nullptr || *fed_keys == '\0') {
+      return KEY_ESCAPE;
+    }
+    return *fed_keys++;
+  }
+
+  if (Replay::is_replaying()) {
+    int ch = Replay::next_key();
+    if (ch == EOF) {
+      endwin();
+      Replay::print_statistics();
+      Game::end(Game::Result::Stopped);
+    }
+    return ch;
+  }
+
+  // Whatever the player sees while thinking, watchers see too
+  Broadcast::publish();
+
+  int ch = getch();
+
+  // The client of a server session went away. Keep the game for next time.
+  // A signal also makes getch() fail, so only give up if it's really gone
+  while (ch == ERR && Server::in_session()) {
+    if (Server::client_gone()) {
+      Game::end(Game::save() ? Game::Result::Saved : Game::Result::Stopped);
+    }
+    ch = getch();
+  }
+
+  if (Replay::is_recording()) {
+    Replay::record(ch);
+  }
+  return ch;
+}
+
 char
 io_readchar(bool is_question)
 {
@@ -500,7 +730,7 @@ io_readchar(bool is_question)
     move(0, static_cast<int>(Game::io->message_buffer.size()));
   }
 
-  char ch = static_cast<char>(getch());
+  char ch = static_cast<char>(io_getch());
   switch (ch)
   {
     case 3:
@@ -512,9 +742,38 @@ io_readchar(bool is_question)
   }
 }
 
+char
+io_readcommand()
+{
+  if (hibernate_after > 0 && Game::io != nullptr && !Game::io->is_headless() &&
+      !Replay::is_replaying()) {
+    Broadcast::publish();
+
+    timeout(hibernate_after * 1000);
+    int ch = getch();
+    timeout(-1);
+
+    // The key is put back, so it's read (and recorded) like any other
+    if (ch == ERR && Game::hibernate()) {
+      ch = getch();
+      Game::wake();
+    }
+    if (ch != ERR) {
+      ungetch(ch);
+    }
+  }
+
+  return io_readchar(false);
+}
+
 void
 io_wait_for_key(int ch)
 {
+  // Nobody to wait for
+  if (Game::io != nullptr && Game::io->is_headless()) {
+    return;
+  }
+
   switch (ch)
   {
     case KEY_ENTER: case '\n':
@@ -532,37 +791,41 @@ io_wait_for_key(int ch)
 void io_missile_motion(Item* item, int ydelta, int xdelta) {
 
   // Come fly with us ...
-  item->set_position(player->get_position());
-
-  for (;;) {
-
-    Coordinate prev_pos = item->get_position();
-
-    // Get the new position
-    item->set_y(item->get_y() + ydelta);
-    item->set_x(item->get_x() + xdelta);
+  Ray::Path path;
+  Ray::cast(player->get_position(), Coordinate(xdelta, ydelta),
+            Ray::Walls | Ray::Monsters, Ray::no_limit, path);
 
-    Coordinate new_pos = item->get_position();
+  Coordinate prev_pos = player->get_position();
+  for (Ray::Cell const& cell : path.cells) {
 
     // Print old position
     if (player->can_see(prev_pos)) {
       Game::io->print_tile(prev_pos);
     }
+    prev_pos = cell.pos;
 
-    // See if we hit something
-    Monster* monster = Game::level->get_monster(new_pos);
-    Tile::Type tile = Game::level->get_tile(new_pos);
-    if (monster != nullptr || tile == Tile::Wall) {
+    // Stop where we hit something
+    if (path.blocked && &cell == &path.cells.back()) {
       break;
     }
 
     // Print new position
-    if (player->can_see(new_pos)) {
-      os_usleep(10000);
-      Game::io->print_color(new_pos.x, new_pos.y, item->o_type);
-      move(new_pos.y, new_pos.x);
-      refresh();
+    if (animation != Animation::Off && player->can_see(cell.pos)) {
+      Coordinate const& camera = Game::io->get_camera();
+      Game::io->print_color(cell.pos.x, cell.pos.y, item->o_type);
+      move(cell.pos.y - camera.y, cell.pos.x - camera.x);
+      io_animation_frame(10000);
     }
   }
+
+  item->set_position(prev_pos);
+}
+
+void io_animation_frame(unsigned usec) {
+  switch (animation) {
+    case Animation::Off: break;
+    case Animation::Instant: refresh(); break;
+    case Animation::Timed: refresh(); os_usleep(usec); break;
+  }
 }
 
@@ -1,18 +1,20 @@
 #pragma once
 
-#include <list>
-
 #include <curses.h>
 #include <string.h>
 
 #include "level_rooms.h"
 #include "coordinate.h"
 #include "item.h"
+#include "message_log.h"
 #include "monster.h"
+#include "tiles.h"
 
 class IO {
 public:
-  IO();
+  // A headless IO draws to /dev/null and reads keys from io_feed_keys().
+  // It always batches messages, see message()
+  explicit IO(bool headless=false);
   ~IO();
 
   enum End {
@@ -62,6 +64,9 @@ public:
   template <typename T>
   void print_color(int x, int y, T ch, Attribute attr=None);
 
+  // Like print_color(), but on extra_screen
+  void print_extra(int x, int y, chtype ch);
+
   void print_tile(Coordinate const& coord);
   void print_tile(int x, int y);
 
@@ -78,34 +83,77 @@ public:
 
   chtype colorize(chtype ch);
 
+  // Build the table colorize() uses. Call again if use_colors changes
+  void init_glyph_colors();
+
+  static Tile tile_symbol(::Tile::Type tile);
+
   void repeat_last_messages();
   void clear_message();
   void show_extra_screen(std::string const& message);
 
   void refresh();
 
+  // Map coordinate at the top left corner of the screen. Maps larger than the
+  // screen scroll to follow the player when refresh() is called
+  Coordinate const& get_camera() const;
+
+  bool is_headless() const;
+
   std::string read_string(WINDOW* win=stdscr, std::string const* initial_string=nullptr);
+
+  // Show message on the message line. When the line is full, a human has to
+  // press space at --More-- before the next line is shown. With batching
+  // (headless, or the batch_messages option) the next line replaces it
+  // right away, and full lines are only kept in last_messages and the batch
   void message(std::string const& message, bool force_flush=false);
 
+  bool batches_messages() const;
+
+  // Lines of messages since clear_message_batch(), oldest first. Only as
+  // many as last_messages holds
+  size_t message_batch_size() const;
+  char const* message_batch_line(size_t i) const;
+  void clear_message_batch();
+
 
   // Temp var
-  std::list<std::string> last_messages;
+  MessageLog last_messages;
   std::string message_buffer;
   WINDOW* extra_screen;
 
 private:
+  bool const headless;
+  bool const batch;
+  size_t     batched_lines;  // Lines logged since clear_message_batch()
+  FILE*      null_device;
+  SCREEN*    screen;
+  Coordinate camera;
+
+  static size_t constexpr glyph_colors_size = 256;
+  chtype     glyph_colors[glyph_colors_size]; // Attributes for each glyph
+
   void print_player_vision();
 
-  void print_tile_seen(Coordinate const& coord);
-  void print_tile_discovered(Coordinate const& coord);
+  // Discover the tiles refresh() would show the player, without drawing
+  void discover_seen();
+
+  // Draw ch at map coordinate x,y, unless it's outside the camera's view
+  void draw(int x, int y, chtype ch, Attribute attr);
+
+  // Move the camera if the player is too close to the edge of the screen
+  void update_camera();
+
+  // What print_tile() draws, or 0 if it should not draw anything
+  chtype render_tile(Coordinate const& coord);
+  chtype render_tile_seen(Coordinate const& coord);
+  chtype render_tile_discovered(Coordinate const& coord);
 
   void refresh_statusline();
 };
 
 #define MAXSTR 1024 // maximum length of strings
 #define MAXINP   50 // max string to read from terminal or environment
-#define MAXLINES 32 // maximum number of screen lines used
-#define MAXCOLS  80 // maximum number of screen columns used
 #define NUMLINES 24
 #define NUMCOLS  80
 #define STATLINE (NUMLINES - 1)
@@ -124,10 +172,25 @@ size_t io_encread(char* start, size_t size, FILE* inf);
 
 void io_missile_motion(Item* item, int ydelta, int xdelta);
 
+/* Show what has been drawn as a frame of an animation, and wait usec if
+ * animations are timed. Only draw the frame if animation != Animation::Off */
+void io_animation_frame(unsigned usec);
+
+
+/* Keys a headless IO will read, before it reads KEY_ESCAPE forever */
+void io_feed_keys(char const* keys);
+
+/* Read a key from the player, or from the replay if replaying */
+int io_getch();
 
 /* Interruptable read char from user (getch) */
 char io_readchar(bool is_question);
 
+/* Read the next command. Hibernates the game if the player is away for
+ * hibernate_after seconds, so only call it when nothing holds on to the
+ * level or the player */
+char io_readcommand();
+
 /* Wait for the specified key */
 void io_wait_for_key(int ch);
 
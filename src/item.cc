@@ -26,7 +26,8 @@ Item::Item()
   : o_type(0), o_launch(0), o_count(1), o_which(0), o_flags(0), o_packch(0),
 
     position_on_screen(0, 0), nickname(""), attack_damage({1, 2}),
-    throw_damage({1, 2}), hit_plus(0), damage_plus(0), armor(0), cursed(false)
+    throw_damage({1, 2}), hit_plus(0), damage_plus(0), armor(0), cursed(false),
+    floor_id(0)
 {}
 
 void Item::set_position(Coordinate const& new_value) {
@@ -129,6 +130,14 @@ bool Item::is_cursed() const {
   return cursed;
 }
 
+void Item::set_floor_id(unsigned long long id) {
+  floor_id = id;
+}
+
+unsigned long long Item::get_floor_id() const {
+  return floor_id;
+}
+
 string Item::name(Item::Type type) {
   switch (type) {
     case Potion: return "potion";
@@ -198,7 +207,7 @@ Item* Item::random() {
   }
 }
 
-void Item::save(std::ofstream& data) const {
+void Item::save(std::ostream& data) const {
   Disk::save_tag(TAG_ITEM, data);
 
   Disk::save(TAG_ITEM_PUBLIC, o_type, data);
@@ -218,7 +227,7 @@ void Item::save(std::ofstream& data) const {
   Disk::save(TAG_ITEM_PRIVATE, cursed, data);
 }
 
-bool Item::load(std::ifstream& data) {
+bool Item::load(std::istream& data) {
   if (!Disk::load_tag(TAG_ITEM, data) ||
 
       !Disk::load(TAG_ITEM_PUBLIC, o_type, data) ||
@@ -44,6 +44,7 @@ public:
   virtual void set_armor(int value);
   virtual void set_cursed();
   virtual void set_not_cursed();
+  void set_floor_id(unsigned long long id);
 
   // Modifiers
   virtual void modify_hit_plus(int amount);
@@ -70,6 +71,7 @@ public:
   virtual int                   get_damage_plus() const;
   virtual int                   get_armor() const;
   virtual bool                  is_cursed() const;
+  unsigned long long            get_floor_id() const; // See Level::add_item()
 
   int           o_type;                // What kind of object it is
   int           o_launch;              // What you need to launch it
@@ -78,8 +80,8 @@ public:
   int           o_flags;               // information about objects
   char          o_packch;              // What character it is in the pack
 
-  virtual void          save(std::ofstream&) const;
-  virtual bool          load(std::ifstream&);
+  virtual void          save(std::ostream&) const;
+  virtual bool          load(std::istream&);
 
   // Static
   static int         probability(Type type);
@@ -98,7 +100,7 @@ private:
   int           damage_plus;           // Plusses to damage
   int           armor;                 // Armor protection
   bool          cursed;
-
+  unsigned long long floor_id;         // 0 when not on the floor
 
   static unsigned long long constexpr TAG_ITEM            = 0x9000000000000000ULL;
   static unsigned long long constexpr TAG_ITEM_PUBLIC     = 0x9000000000000001ULL;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <list>
 
 #include "amulet.h"
@@ -6,11 +7,13 @@
 #include "traps.h"
 #include "io.h"
 #include "daemons.h"
+#include "disk.h"
 #include "monster.h"
 #include "misc.h"
 #include "player.h"
 #include "level_rooms.h"
 #include "os.h"
+#include "profile.h"
 #include "rogue.h"
 
 #include "level.h"
@@ -23,6 +26,10 @@ int constexpr Level::max_traps;
 int constexpr Level::treasure_room_chance;
 int constexpr Level::treasure_room_max_items;
 int constexpr Level::treasure_room_min_items;
+int constexpr Level::min_room_space_x;
+int constexpr Level::min_room_space_y;
+unsigned char constexpr Level::no_room;
+Level::Shape constexpr Level::default_shape;
 
 void Level::create_treasure_room() {
 
@@ -35,9 +42,12 @@ void Level::create_treasure_room() {
     Coordinate item_pos;
     Item* item = Item::random();
 
-    get_random_room_coord(&room, &item_pos, 2 * max_monsters, false);
+    if (!get_random_room_coord(&room, &item_pos, false)) {
+      delete item;
+      break;
+    }
     item->set_position(item_pos);
-    items.push_back(item);
+    add_item(item);
   }
 
   // fill up room with monsters from the next level down
@@ -48,19 +58,18 @@ void Level::create_treasure_room() {
   Game::current_level++;
   for (int i = 0; i < num_monsters; ++i) {
     Coordinate monster_pos;
-    if (get_random_room_coord(&room, &monster_pos, max_monsters, true)) {
+    if (get_random_room_coord(&room, &monster_pos, true)) {
       Monster::Type mon_type = Monster::random_monster_type_for_level();
       Monster* monster = new Monster(mon_type, monster_pos);
       monster->set_mean();  // no sloughers in THIS room
-      monsters.push_back(monster);
       monster->give_pack();
-      set_monster(monster_pos, monster);
+      add_monster(monster, 0);
     }
   }
   Game::current_level--;
 }
 
-void Level::create_loot() {
+void Level::create_loot(bool place_amulet) {
 
   // check for treasure rooms, and if so, put it in.
   if (os_rand_range(100) < treasure_room_chance) {
@@ -72,26 +81,30 @@ void Level::create_loot() {
     if (os_rand_range(100) < 36) {
       // Pick a new object and link it in the list
       Item* obj = Item::random();
-      items.push_back(obj);
 
       // Put it somewhere
       Coordinate pos;
-      get_random_room_coord(nullptr, &pos, 0, false);
+      if (!get_random_room_coord(nullptr, &pos, false)) {
+        delete obj;
+        break;
+      }
       obj->set_position(pos);
+      add_item(obj);
     }
   }
 
   // If he is really deep in the dungeon and he hasn't found the
   // amulet yet, put it somewhere on the ground
-  if (player != nullptr && !player->pack_contains_amulet() &&
-      Game::current_level >= Game::amulet_min_level) {
+  if (place_amulet && Game::current_level >= Game::amulet_min_level) {
     Amulet* amulet = new Amulet();
-    items.push_back(amulet);
 
     // Put it somewhere
     Coordinate pos;
-    get_random_room_coord(nullptr, &pos, 0, false);
+    if (!get_random_room_coord(nullptr, &pos, false)) {
+      error("No room for the amulet");
+    }
     amulet->set_position(pos);
+    add_item(amulet);
   }
 }
 
@@ -114,9 +127,10 @@ void Level::create_traps() {
   if (os_rand_range(10) < Game::current_level) {
     int ntraps = min(os_rand_range(Game::current_level / 4) + 1, max_traps);
     for (int i = 0; i < ntraps; ++i) {
-      do {
-        get_random_room_coord(nullptr, &stairs_coord, 0, false);
-      } while (get_tile(stairs_coord) != Tile::Floor);
+      // Only floor is picked, so there is nowhere left once this fails
+      if (!get_random_room_coord(nullptr, &stairs_coord, false)) {
+        break;
+      }
 
       set_not_real(stairs_coord);
       Trap::Type trap_type = static_cast<Trap::Type>(os_rand_range(Trap::NTRAPS));
@@ -126,32 +140,294 @@ void Level::create_traps() {
 }
 
 void Level::create_stairs() {
-  get_random_room_coord(nullptr, &stairs_coord, 0, false);
+  if (!get_random_room_coord(nullptr, &stairs_coord, false)) {
+    error("No room for the stairs");
+  }
   set_tile(stairs_coord, Tile::Stairs);
 }
 
 
-Level::Level() : items(), monsters(), shop(), rooms(), tiles(), stairs_coord({0,0}) {
-  tiles.resize(MAXLINES * MAXCOLS);
-  if (player != nullptr) {
-    player->set_previous_room(nullptr);
-  }
+// May run on the pregeneration worker (see pregen.h), so it must not touch
+// the player or the screen
+Level::Level(Shape const& shape_, bool place_amulet)
+  : items(), monsters(), shop(), schedule(), shape(shape_), rooms(), tiles(), room_plane(),
+    floor_cells(), open_cells(), run_stops(), walls(), closed_doors(), item_cells(),
+    run_from(), run_direction(), run_clear(0), stairs_coord({0,0}), maze_stack(),
+    items_by_id(), next_floor_id(1) {
 
-  clear();
+  string const shape_error = check_shape(shape);
+  if (!shape_error.empty()) {
+    error(shape_error);
+  }
 
-  rooms.resize(9);
+  tiles.resize(static_cast<size_t>(shape.width * shape.height));
+  rooms.resize(static_cast<size_t>(shape.room_columns * shape.room_rows));
   create_rooms();
 
   create_passages();
 
   Game::levels_without_food++;
-  create_loot();
+  create_loot(place_amulet);
   create_traps();
   create_stairs();
+  index_run_stops();
+}
+
+Level::Level(Level const& other)
+  : items(), monsters(), shop(nullptr), schedule(), shape(other.shape), rooms(other.rooms),
+    tiles(other.tiles), room_plane(other.room_plane),
+    floor_cells(other.floor_cells), open_cells(other.open_cells),
+    run_stops(other.run_stops), walls(other.walls),
+    closed_doors(other.closed_doors), item_cells(other.item_cells),
+    run_from(), run_direction(), run_clear(0), stairs_coord(other.stairs_coord),
+    maze_stack(), items_by_id(), next_floor_id(other.next_floor_id) {
+
+  for (Item* other_item : other.items) {
+    Item* item = other_item->clone();
+    items.push_back(item);
+    items_by_id[item->get_floor_id()] = item;
+  }
+
+  if (other.shop != nullptr) {
+    shop = new Shop(*other.shop);
+  }
+
+  for (Tile& t : tiles) {
+    t.monster = nullptr;
+  }
+
+  for (Monster* other_monster : other.monsters) {
+    Monster* monster = new Monster(*other_monster);
+    monsters.push_back(monster);
+    set_monster(monster->get_position(), monster);
+
+    long long tick = 0;
+    unsigned long long order = 0;
+    if (other.schedule.find(other_monster, tick, order)) {
+      schedule.push(monster, tick, order);
+    }
+  }
+}
+
+// Which of items a monster's target is, as 0 for none, 1 for the player and
+// 2 + index for an item. Floor ids are handed out again on load, so they are
+// saved as this
+static int target_index(Monster const* monster, list<Item*> const& items) {
+  Target const& target = monster->get_target();
+  if (target.kind == Target::Kind::None) {
+    return 0;
+  } else if (target.kind == Target::Kind::Player) {
+    return 1;
+  }
+
+  int index = 2;
+  for (Item const* item : items) {
+    if (item->get_floor_id() == target.floor_id) {
+      return index;
+    }
+    ++index;
+  }
+
+  // The item is gone, so Monster::take_turn() sends it for the player
+  return 1;
+}
+
+void Level::save(ostream& data) const {
+  Disk::save_tag(TAG_LEVEL, data);
+  Disk::save(TAG_LEVEL, shape.width, data);
+  Disk::save(TAG_LEVEL, shape.height, data);
+  Disk::save(TAG_LEVEL, shape.room_columns, data);
+  Disk::save(TAG_LEVEL, shape.room_rows, data);
+  Disk::save(TAG_LEVEL, stairs_coord, data);
+
+  Disk::save_tag(TAG_ROOMS, data);
+  for (room const& r : rooms) {
+    Disk::save(TAG_ROOMS, r.r_pos, data);
+    Disk::save(TAG_ROOMS, r.r_max, data);
+    Disk::save(TAG_ROOMS, r.r_gold, data);
+    Disk::save(TAG_ROOMS, r.r_goldval, data);
+    Disk::save(TAG_ROOMS, r.r_flags, data);
+    Disk::save(TAG_ROOMS, r.r_nexits, data);
+    for (Coordinate const& exit : r.r_exit) {
+      Disk::save(TAG_ROOMS, exit, data);
+    }
+  }
+
+  // Two bytes a tile: the type and its flags, then the trap type
+  string packed;
+  packed.reserve(tiles.size() * 2);
+  for (Tile const& t : tiles) {
+    packed += static_cast<char>(t.type | t.is_passage << 3 |
+                                t.is_discovered << 4 | t.is_real << 5 |
+                                t.is_dark << 6 | t.is_mapped << 7);
+    packed += static_cast<char>(t.trap_type);
+  }
+  Disk::save(TAG_TILES, packed, data);
+
+  Disk::save(TAG_ITEMS, items, data);
+
+  Disk::save_tag(TAG_MONSTERS, data);
+  Disk::save(TAG_MONSTERS, monsters.size(), data);
+  for (Monster const* monster : monsters) {
+    monster->save(data);
+    Disk::save(TAG_MONSTERS, target_index(monster, items), data);
+
+    long long tick = 0;
+    unsigned long long order = 0;
+    schedule.find(monster, tick, order);
+    Disk::save(TAG_MONSTERS, tick, data);
+    Disk::save(TAG_MONSTERS, order, data);
+  }
+
+  Disk::save(TAG_SHOP, shop != nullptr, data);
+  if (shop != nullptr) {
+    shop->save(data);
+  }
+}
+
+Level::Level(istream& data)
+  : items(), monsters(), shop(nullptr), schedule(), shape(), rooms(), tiles(), room_plane(),
+    floor_cells(), open_cells(), run_stops(), walls(), closed_doors(), item_cells(),
+    run_from(), run_direction(), run_clear(0), stairs_coord({0,0}), maze_stack(),
+    items_by_id(), next_floor_id(1) {
+
+  if (!Disk::load_tag(TAG_LEVEL, data) ||
+      !Disk::load(TAG_LEVEL, shape.width, data) ||
+      !Disk::load(TAG_LEVEL, shape.height, data) ||
+      !Disk::load(TAG_LEVEL, shape.room_columns, data) ||
+      !Disk::load(TAG_LEVEL, shape.room_rows, data) ||
+      !Disk::load(TAG_LEVEL, stairs_coord, data) ||
+      !check_shape(shape).empty()) {
+    error("Level tag error");
+  }
+
+  rooms.resize(static_cast<size_t>(shape.room_columns * shape.room_rows));
+  if (!Disk::load_tag(TAG_ROOMS, data)) {
+    error("Room tag error");
+  }
+  for (room& r : rooms) {
+    if (!Disk::load(TAG_ROOMS, r.r_pos, data) ||
+        !Disk::load(TAG_ROOMS, r.r_max, data) ||
+        !Disk::load(TAG_ROOMS, r.r_gold, data) ||
+        !Disk::load(TAG_ROOMS, r.r_goldval, data) ||
+        !Disk::load(TAG_ROOMS, r.r_flags, data) ||
+        !Disk::load(TAG_ROOMS, r.r_nexits, data)) {
+      error("Room tag error");
+    }
+    for (Coordinate& exit : r.r_exit) {
+      if (!Disk::load(TAG_ROOMS, exit, data)) {
+        error("Room tag error");
+      }
+    }
+  }
+
+  string packed;
+  tiles.resize(static_cast<size_t>(shape.width * shape.height));
+  if (!Disk::load(TAG_TILES, packed, data) || packed.size() != tiles.size() * 2) {
+    error("Tile tag error");
+  }
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    int const flags = static_cast<unsigned char>(packed.at(i * 2));
+    tiles.at(i).type          = static_cast<Tile::Type>(flags & 07);
+    tiles.at(i).is_passage    = flags & (1 << 3);
+    tiles.at(i).is_discovered = flags & (1 << 4);
+    tiles.at(i).is_real       = flags & (1 << 5);
+    tiles.at(i).is_dark       = flags & (1 << 6);
+    tiles.at(i).is_mapped     = flags & (1 << 7);
+    tiles.at(i).trap_type     = static_cast<Trap::Type>(packed.at(i * 2 + 1));
+  }
+
+  if (!Disk::load(TAG_ITEMS, items, data)) {
+    error("Item tag error");
+  }
+  for (Item* item : items) {
+    item->set_floor_id(next_floor_id++);
+    items_by_id[item->get_floor_id()] = item;
+  }
+
+  size_t num_monsters = 0;
+  if (!Disk::load_tag(TAG_MONSTERS, data) ||
+      !Disk::load(TAG_MONSTERS, num_monsters, data)) {
+    error("Monster tag error");
+  }
+  for (size_t i = 0; i < num_monsters; ++i) {
+    Monster* monster = new Monster(data);
+    monsters.push_back(monster);
+    tile(monster->get_position().x, monster->get_position().y).monster = monster;
+
+    int target = 0;
+    if (!Disk::load(TAG_MONSTERS, target, data) ||
+        target < 0 || static_cast<size_t>(target) > items.size() + 1) {
+      error("Monster tag error");
+    } else if (target == 1) {
+      monster->set_target(Target::player());
+    } else if (target > 1) {
+      auto item = items.cbegin();
+      advance(item, target - 2);
+      monster->set_target(Target::item(**item));
+    }
+
+    long long tick = 0;
+    unsigned long long order = 0;
+    if (!Disk::load(TAG_MONSTERS, tick, data) ||
+        !Disk::load(TAG_MONSTERS, order, data)) {
+      error("Monster tag error");
+    } else if (monster->is_awake()) {
+      schedule.push(monster, tick, order);
+    }
+  }
+
+  bool has_shop = false;
+  if (!Disk::load(TAG_SHOP, has_shop, data)) {
+    error("Shop tag error");
+  }
+  if (has_shop) {
+    shop = new Shop(data);
+  }
+
+  index_rooms();
+  index_run_stops();
+}
+
+string Level::check_shape(Shape const& shape) {
+  if (shape.width < NUMCOLS || shape.height < NUMLINES) {
+    return "The map must be at least " + to_string(NUMCOLS) + "x" +
+      to_string(NUMLINES);
+  }
+
+  if (shape.room_columns < 1 || shape.room_rows < 1 ||
+      shape.room_columns * shape.room_rows < 2) {
+    return "There must be at least two rooms";
+  }
+
+  if (shape.room_columns * shape.room_rows >= no_room) {
+    return "There can be at most " + to_string(no_room - 1) + " rooms";
+  }
+
+  // Room space per room, see create_rooms()
+  if ((shape.width - 1) / shape.room_columns < min_room_space_x ||
+      shape.height / shape.room_rows < min_room_space_y) {
+    return "Too many rooms for the map, each room needs at least " +
+      to_string(min_room_space_x) + "x" + to_string(min_room_space_y);
+  }
+
+  return "";
+}
+
+Level::Shape const& Level::get_shape() const {
+  return shape;
+}
+
+int Level::get_width() const {
+  return shape.width;
+}
+
+int Level::get_height() const {
+  return shape.height;
 }
 
 Tile& Level::tile(int x, int y) {
-  size_t pos = static_cast<size_t>((x << 5) + y);
+  size_t pos = static_cast<size_t>(y * shape.width + x);
   return tiles.at(pos);
 }
 
@@ -164,6 +440,11 @@ Monster* Level::get_monster(Coordinate const& coord) {
 }
 
 Item* Level::get_item(int x, int y) {
+  PROFILE_SCOPE(GetItem);
+  if (!item_cells.contains(x, y)) {
+    return nullptr;
+  }
+
   auto results = find_if(items.begin(), items.end(),
       [&] (Item* i) {
     return i->get_x() == x && i->get_y() == y;
@@ -178,14 +459,61 @@ Item* Level::get_item(Coordinate const& coord) {
   return get_item(coord.x, coord.y);
 }
 
+Item* Level::get_item_by_id(unsigned long long floor_id) {
+  auto it = items_by_id.find(floor_id);
+  return it == items_by_id.end() ? nullptr : it->second;
+}
+
 void Level::set_monster(int x, int y, Monster* monster) {
   tile(x, y).monster = monster;
+  update_cells(x, y);
 }
 
 void Level::set_monster(Coordinate const& coord, Monster* monster) {
   set_monster(coord.x, coord.y, monster);
 }
 
+void Level::add_monster(Monster* monster, long long tick) {
+  monsters.push_back(monster);
+  set_monster(monster->get_position(), monster);
+  if (monster->is_awake()) {
+    schedule.push(monster, tick);
+  }
+}
+
+void Level::wake_monster(Monster* monster) {
+  if (monster->is_awake() && !schedule.contains(monster)) {
+    schedule.push(monster, Schedule::turn_start());
+  }
+}
+
+void Level::remove_monster(Monster* monster) {
+  set_monster(monster->get_position(), nullptr);
+  monsters.remove(monster);
+  schedule.remove(monster);
+}
+
+void Level::add_item(Item* item) {
+  item->set_floor_id(next_floor_id++);
+  items.push_back(item);
+  items_by_id[item->get_floor_id()] = item;
+
+  Coordinate const& pos = item->get_position();
+  item_cells.set(pos.x, pos.y, true);
+  update_run_stop(pos.x, pos.y);
+}
+
+void Level::remove_item(Item* item) {
+  items.remove(item);
+  items_by_id.erase(item->get_floor_id());
+  item->set_floor_id(0);
+
+  // There can be more than one item on a tile
+  Coordinate const& pos = item->get_position();
+  item_cells.set(pos.x, pos.y, get_item(pos) != nullptr);
+  update_run_stop(pos.x, pos.y);
+}
+
 bool Level::is_passage(int x, int y) {
   return tile(x, y).is_passage;
 }
@@ -202,6 +530,14 @@ bool Level::is_discovered(Coordinate const& coord) {
   return is_discovered(coord.x, coord.y);
 }
 
+bool Level::is_mapped(int x, int y) {
+  return tile(x, y).is_mapped;
+}
+
+bool Level::is_mapped(Coordinate const& coord) {
+  return is_mapped(coord.x, coord.y);
+}
+
 bool Level::is_real(int x, int y) {
   return tile(x, y).is_real;
 }
@@ -226,6 +562,14 @@ void Level::set_discovered(Coordinate const& coord) {
   set_discovered(coord.x, coord.y);
 }
 
+void Level::set_mapped(int x, int y) {
+  tile(x, y).is_mapped = true;
+}
+
+void Level::set_mapped(Coordinate const& coord) {
+  set_mapped(coord.x, coord.y);
+}
+
 void Level::set_real(int x, int y) {
   tile(x, y).is_real = true;
 }
@@ -252,6 +596,8 @@ Tile::Type Level::get_tile(Coordinate const& coord) {
 
 void Level::set_tile(int x, int y, Tile::Type type) {
   tile(x, y).type = type;
+  update_cells(x, y);
+  update_run_stop(x, y);
 }
 
 void Level::set_tile(Coordinate const& coord, Tile::Type tile) {
@@ -275,17 +621,202 @@ Trap::Type Level::get_trap_type(Coordinate const& coord) {
 }
 
 room* Level::get_room(Coordinate const& coord) {
-  for (struct room& room : rooms) {
-    if (coord.x <= room.r_pos.x + room.r_max.x
-        && room.r_pos.x <= coord.x
-        && coord.y <= room.r_pos.y + room.r_max.y
-        && room.r_pos.y <= coord.y) {
-      return &room;
+  return get_room_by_id(get_room_id(coord));
+}
+
+int Level::get_room_id(Coordinate const& coord) const {
+  if (coord.x < 0 || coord.x >= shape.width || coord.y < 0 || coord.y >= shape.height) {
+    return -1;
+  }
+
+  unsigned char id = room_plane.at(static_cast<size_t>(coord.y * shape.width + coord.x));
+  return id == no_room ? -1 : id;
+}
+
+void Level::index_rooms() {
+  room_plane.assign(tiles.size(), no_room);
+  floor_cells.assign(rooms.size(), CellSet());
+  open_cells.assign(rooms.size(), CellSet());
+  for (size_t id = 0; id < rooms.size(); ++id) {
+    index_room(id);
+  }
+}
+
+void Level::index_room(size_t id) {
+  // A room covers its walls and the line past them. Where two rooms touch,
+  // the one with the lowest id owns the tile, so add them in order. Gone
+  // rooms have negative sizes and cover nothing
+  room const& r = rooms.at(id);
+  int const max_x = min(r.r_pos.x + r.r_max.x, shape.width - 1);
+  int const max_y = min(r.r_pos.y + r.r_max.y, shape.height - 1);
+  for (int y = max(r.r_pos.y, 0); y <= max_y; ++y) {
+    for (int x = max(r.r_pos.x, 0); x <= max_x; ++x) {
+      unsigned char& cell = room_plane.at(static_cast<size_t>(y * shape.width + x));
+      if (cell == no_room) {
+        cell = static_cast<unsigned char>(id);
+      }
+    }
+  }
+
+  // Random placement picks from inside the walls
+  Coordinate const inside(r.r_pos.x + 1, r.r_pos.y + 1);
+  Coordinate const inside_size(r.r_max.x - 2, r.r_max.y - 2);
+  floor_cells.at(id) = CellSet(inside, inside_size);
+  open_cells.at(id) = CellSet(inside, inside_size);
+  for (int y = max(inside.y, 0); y < min(inside.y + inside_size.y, shape.height); ++y) {
+    for (int x = max(inside.x, 0); x < min(inside.x + inside_size.x, shape.width); ++x) {
+      update_cells(x, y);
+    }
+  }
+}
+
+void Level::update_cells(int x, int y) {
+  int const id = get_room_id(Coordinate(x, y));
+  if (id == -1) {
+    return;
+  }
+
+  Tile const& t = tile(x, y);
+  floor_cells.at(static_cast<size_t>(id)).set(x, y, t.type == Tile::Floor);
+  open_cells.at(static_cast<size_t>(id)).set(x, y,
+      t.monster == nullptr && t.type != Tile::Wall && t.type != Tile::ClosedDoor);
+}
+
+void Level::index_run_stops() {
+  Coordinate const size(shape.width, shape.height);
+  run_stops = CellSet(Coordinate(0, 0), size);
+  walls = CellSet(Coordinate(0, 0), size);
+  closed_doors = CellSet(Coordinate(0, 0), size);
+  item_cells = CellSet(Coordinate(0, 0), size);
+  for (Item const* item : items) {
+    item_cells.set(item->get_x(), item->get_y(), true);
+  }
+
+  for (int y = 0; y < shape.height; ++y) {
+    for (int x = 0; x < shape.width; ++x) {
+      update_run_stop(x, y);
+    }
+  }
+}
+
+void Level::update_run_stop(int x, int y) {
+  Tile::Type const type = tile(x, y).type;
+  run_stops.set(x, y, type == Tile::Stairs || type == Tile::Trap ||
+                type == Tile::OpenDoor || item_cells.contains(x, y));
+  walls.set(x, y, type == Tile::Wall);
+  closed_doors.set(x, y, type == Tile::ClosedDoor);
+  run_clear = 0;  // is_run_stop() has to look again
+}
+
+bool Level::has_run_stop_near(Coordinate const& coord) const {
+  return run_stops.contains_any(Coordinate(coord.x - 1, coord.y - 1),
+                                Coordinate(coord.x + 1, coord.y + 1));
+}
+
+bool Level::is_run_stop(Coordinate const& coord, int dx, int dy) {
+  Coordinate const direction(dx, dy);
+
+  // Still on the stretch the last look ahead found clear?
+  if (direction == run_direction) {
+    int const step = dx != 0 ? (coord.x - run_from.x) * dx : (coord.y - run_from.y) * dy;
+    if (step >= 1 && step <= run_clear &&
+        coord == Coordinate(run_from.x + step * dx, run_from.y + step * dy)) {
+      return false;
     }
   }
 
-  // Was corridor, probably
-  return nullptr;
+  run_from = Coordinate(coord.x - dx, coord.y - dy);
+  run_direction = direction;
+  run_clear = run_steps_clear(run_from, dx, dy);
+  return run_clear == 0;
+}
+
+// Steps from from, going dx, dy, before one where is_run_stop() is true. It
+// doesn't look further than the first step into a wall or closed door, or
+// the edge of the map, since the run ends there anyway
+int Level::run_steps_clear(Coordinate const& from, int dx, int dy) const {
+  int max_steps = max(shape.width, shape.height);
+  if (dx != 0) {
+    max_steps = min(max_steps, dx > 0 ? shape.width - 2 - from.x : from.x - 1);
+  }
+  if (dy != 0) {
+    max_steps = min(max_steps, dy > 0 ? shape.height - 2 - from.y : from.y - 1);
+  }
+  max_steps = max(max_steps, 0);
+
+  // Along a row, 62 tiles at a time. Where a run would stop or end,
+  // whichever comes first
+  if (dy == 0) {
+    for (int steps = 0; steps < max_steps; steps += 62) {
+      int const first = from.x + (steps + 1) * dx;
+      int const x = dx > 0 ? first - 1 : first - 62;
+      uint64_t const stops = run_stop_bits(x, from.y, dx);
+      uint64_t const ends = (walls.row(x, from.y) | closed_doors.row(x, from.y)) &
+                            0x7ffffffffffffffeULL;
+      if ((stops | ends) != 0) {
+        auto nearest = [dx] (uint64_t found) {
+          return found == 0 ? 64 : dx > 0 ? __builtin_ctzll(found) - 1 : __builtin_clzll(found) - 1;
+        };
+        return min(steps + min(nearest(stops), nearest(ends) + 1), max_steps);
+      }
+    }
+    return max_steps;
+  }
+
+  // Down a column, the three tiles across are one word per row, and each
+  // row is looked at once
+  if (dx == 0) {
+    int const x = from.x - 1;
+    uint64_t stops_behind = run_stops.row(x, from.y);
+    uint64_t stops_here = run_stops.row(x, from.y + dy);
+    uint64_t walls_behind = walls.row(x, from.y);
+    for (int steps = 0; steps < max_steps; ++steps) {
+      int const y = from.y + (steps + 1) * dy;
+      uint64_t const stops_ahead = run_stops.row(x, y + dy);
+      uint64_t const walls_here = walls.row(x, y);
+      if (((stops_behind | stops_here | stops_ahead) & 07) || (walls_behind & ~walls_here & 05)) {
+        return steps;
+      } else if ((walls_here | closed_doors.row(x, y)) & 02) {
+        return steps + 1;
+      }
+      stops_behind = stops_here;
+      stops_here = stops_ahead;
+      walls_behind = walls_here;
+    }
+    return max_steps;
+  }
+
+  // Corridors don't fork for diagonal runs
+  for (int steps = 0; steps < max_steps; ++steps) {
+    Coordinate const step(from.x + (steps + 1) * dx, from.y + (steps + 1) * dy);
+    if (has_run_stop_near(step)) {
+      return steps;
+    } else if (walls.contains(step.x, step.y) || closed_doors.contains(step.x, step.y)) {
+      return steps + 1;
+    }
+  }
+  return max_steps;
+}
+
+// Bit i is set if stepping onto x + i of row y, going dx, stops a run, for
+// 1 <= i <= 62. The other bits lack a neighbour to tell
+uint64_t Level::run_stop_bits(int x, int y, int dx) const {
+  uint64_t const near = run_stops.row(x, y - 1) | run_stops.row(x, y) | run_stops.row(x, y + 1);
+  uint64_t stops = near | near << 1 | near >> 1;
+
+  // A wall beside the last step but none beside this one is a fork
+  for (int side = y - 1; side <= y + 1; side += 2) {
+    uint64_t const wall = walls.row(x, side);
+    stops |= (dx > 0 ? wall << 1 : wall >> 1) & ~wall;
+  }
+  return stops & 0x7ffffffffffffffeULL;
+}
+
+room* Level::get_room_by_id(int id) {
+  if (id == -1) {
+    return nullptr;
+  }
+  return &rooms.at(static_cast<size_t>(id));
 }
 
 Coordinate const& Level::get_stairs_pos() const {
@@ -3,7 +3,10 @@
 #include <list>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
+#include "cell_set.h"
+#include "scheduler.h"
 #include "traps.h"
 #include "monster.h"
 #include "item.h"
@@ -13,18 +16,42 @@
 
 class Level {
 public:
-  Level();
+  // Size of the map, and how many rooms go across and down it. The top and
+  // bottom rows are never dug out, the screen uses them for text
+  struct Shape {
+    int width;
+    int height;
+    int room_columns;
+    int room_rows;
+  };
+
+  static Shape constexpr default_shape = { NUMCOLS, NUMLINES, 3, 3 };
+
+  // Error message if shape cannot be used, else empty
+  static std::string check_shape(Shape const& shape);
+
+  Level(Shape const& shape, bool place_amulet); // Amulet only goes deep enough
+  Level(Level const&); // Copies monsters and items as well
+  explicit Level(std::istream&);
   ~Level();
 
+  Level& operator=(Level const&) = delete;
+
   // Getters
+  Shape const& get_shape() const;
+  int get_width() const;
+  int get_height() const;
   Monster* get_monster(int x, int y);
   Monster* get_monster(Coordinate const& coord);
   Item* get_item(int x, int y);
   Item* get_item(Coordinate const& coord);
+  Item* get_item_by_id(unsigned long long floor_id); // nullptr if not on the floor
   bool is_passage(int x, int y);
   bool is_passage(Coordinate const& coord);
   bool is_discovered(int x, int y);
   bool is_discovered(Coordinate const& coord);
+  bool is_mapped(int x, int y);
+  bool is_mapped(Coordinate const& coord);
   bool is_real(int x, int y);
   bool is_real(Coordinate const& coord);
   bool is_dark(int x, int y);
@@ -33,9 +60,14 @@ public:
   Tile::Type get_tile(Coordinate const& coord);
   Trap::Type get_trap_type(int x, int y);
   Trap::Type get_trap_type(Coordinate const& coord);
-  bool get_random_room_coord(room* room, Coordinate* coord, int tries, bool monster);
-  room* get_room(Coordinate const& coord);
+  // A random floor tile in room (any room if nullptr), or where a monster
+  // could go if monster, other than avoid. False if there is none
+  bool get_random_room_coord(room* room, Coordinate* coord, bool monster,
+                             Coordinate const* avoid = nullptr);
+  room* get_room(Coordinate const& coord);        // nullptr if not in a room
+  int get_room_id(Coordinate const& coord) const; // -1 if not in a room
   room* get_random_room();
+  room* get_room_by_id(int id);            // nullptr for -1
   Coordinate const& get_stairs_pos() const;
   int get_stairs_x() const;
   int get_stairs_y() const;
@@ -47,6 +79,8 @@ public:
   void set_passage(Coordinate const& coord);
   void set_discovered(int x, int y);
   void set_discovered(Coordinate const& coord);
+  void set_mapped(int x, int y);
+  void set_mapped(Coordinate const& coord);
   void set_real(int x, int y);
   void set_real(Coordinate const& coord);
   void set_not_real(int x, int y);
@@ -56,15 +90,41 @@ public:
   void set_trap_type(int x, int y, Trap::Type type);
   void set_trap_type(Coordinate const& coord, Trap::Type type);
 
+  // Put monster on the level, to act first at tick if it is awake (see
+  // Monster::is_awake()). Takes ownership
+  void add_monster(Monster* monster, long long tick);
+  // Queue a monster which just woke up, to act from this turn on
+  void wake_monster(Monster* monster);
+  // Take monster off the level. Caller gets ownership
+  void remove_monster(Monster* monster);
+
+  // Put item on the floor, where it gets a floor id of its own. Copies of
+  // the level keep the ids. Takes ownership
+  void add_item(Item* item);
+  // Take item off the floor. Caller gets ownership
+  void remove_item(Item* item);
+
   // Misc
+  void save(std::ostream&) const;
   void wizard_show_passages();
   bool can_step(int x, int y);
   bool can_step(Coordinate const& coord);
 
+  // True if stairs, traps, open doors or items are on or next to coord,
+  // which stops a careful run (see move.cc)
+  bool has_run_stop_near(Coordinate const& coord) const;
+
+  // True if a careful run stepping onto coord, going dx, dy, should stop for
+  // what is on the map: has_run_stop_near(), or a corridor forking off. Looks
+  // ahead along the run a word of tiles at a time, and remembers how far it
+  // is clear until the map changes, so most steps of a run are a compare
+  bool is_run_stop(Coordinate const& coord, int dx, int dy);
+
   // Variables
   std::list<Item*>    items;    // List of items on level
   std::list<Monster*> monsters; // List of monsters on level
   Shop*               shop;     // Ye local shop
+  Schedule::Queue<Monster> schedule; // When awake monsters act next
 
 private:
 
@@ -75,10 +135,13 @@ private:
   static int constexpr treasure_room_chance = 5;
   static int constexpr treasure_room_max_items = 10;
   static int constexpr treasure_room_min_items = 2;
+  static int constexpr min_room_space_x = 8;
+  static int constexpr min_room_space_y = 8;
+  static unsigned char constexpr no_room = 0xff; // In room_plane, so 255 rooms at most
 
   void create_rooms();
   void create_passages();
-  void create_loot();
+  void create_loot(bool place_amulet);
   void create_traps();
   void create_stairs();
 
@@ -86,7 +149,7 @@ private:
   void create_treasure_room();
   void draw_room(room const& room);
   void draw_maze(room const& room);
-  void draw_maze_recursive(int y, int x, int starty, int startx, int maxy, int maxx);
+  void carve_maze(Coordinate const& start, Coordinate const& room_pos, Coordinate const& room_max);
 
   // Part of create_passages()
   void place_door(room* room, Coordinate* coord);
@@ -96,9 +159,37 @@ private:
 
   // Misc
   Tile& tile(int x, int y);
+  void index_rooms();          // Fill room_plane and cells from rooms
+  void index_room(size_t id);  // Add a room to room_plane and cells
+  void update_cells(int x, int y); // After the tile changed
+  void index_run_stops();          // Fill run_stops, walls, closed_doors and item_cells
+  void update_run_stop(int x, int y); // After the tile or its items changed
+  int run_steps_clear(Coordinate const& from, int dx, int dy) const; // Part of is_run_stop()
+  uint64_t run_stop_bits(int x, int y, int dx) const;       // Part of run_steps_clear()
 
   // Variables
+  Shape              shape;
   std::vector<room>  rooms;         // all rooms on level
-  std::vector<Tile>  tiles;        // level map
+  std::vector<Tile>  tiles;        // level map, a row at a time
+  std::vector<unsigned char> room_plane; // Room id of each tile, like tiles
+  std::vector<CellSet> floor_cells; // Floor inside each room
+  std::vector<CellSet> open_cells;  // Where monsters could go, in each room
+  CellSet            run_stops;     // See has_run_stop_near()
+  CellSet            walls;         // For corridor forks, see is_run_stop()
+  CellSet            closed_doors;  // Walls and these end a run, see is_run_stop()
+  CellSet            item_cells;    // Where items are, so get_item() seldom has to look
+  Coordinate         run_from;      // Where is_run_stop() last looked ahead from,
+  Coordinate         run_direction; // which way,
+  int                run_clear;     // and how many steps were clear
   Coordinate         stairs_coord;  // Where the stairs are
+  std::vector<Coordinate> maze_stack; // Scratch space for carve_maze(), not copied
+  std::unordered_map<unsigned long long, Item*> items_by_id; // See add_item()
+  unsigned long long next_floor_id;
+
+  static unsigned long long constexpr TAG_LEVEL    = 0xd000000000000000ULL;
+  static unsigned long long constexpr TAG_TILES    = 0xd000000000000001ULL;
+  static unsigned long long constexpr TAG_ROOMS    = 0xd000000000000002ULL;
+  static unsigned long long constexpr TAG_ITEMS    = 0xd000000000000003ULL;
+  static unsigned long long constexpr TAG_MONSTERS = 0xd000000000000004ULL;
+  static unsigned long long constexpr TAG_SHOP     = 0xd000000000000005ULL;
 };
@@ -39,24 +39,9 @@ Level::place_door(room* room, Coordinate* coord) {
  * Draw a corridor from a room in a certain direction. */
 void
 Level::connect_passages(int r1, int r2) {
-  int rm;
-  char direc;
-  if (r1 < r2) {
-    rm = r1;
-    if (r1 + 1 == r2) {
-      direc = 'r';
-    } else {
-      direc = 'd';
-    }
-
-  } else {
-    rm = r2;
-    if (r2 + 1 == r1) {
-      direc = 'r';
-    } else {
-      direc = 'd';
-    }
-  }
+  // Rooms are next to each other, so they are either a row or a column apart
+  int rm = min(r1, r2);
+  char direc = abs(r1 - r2) == shape.room_columns ? 'd' : 'r';
 
   room* room_from = &rooms.at(static_cast<size_t>(rm));
   room* room_to = nullptr;           /* room pointer of dest */
@@ -70,7 +55,7 @@ Level::connect_passages(int r1, int r2) {
     /* Set up the movement variables, in two cases:
      * first drawing one down.  */
   if (direc == 'd') {
-    room_to = &rooms.at(static_cast<size_t>(rm + 3));
+    room_to = &rooms.at(static_cast<size_t>(rm + shape.room_columns));
     del.x = 0;
     del.y = 1;
     start_pos.x = room_from->r_pos.x;
@@ -134,7 +119,8 @@ Level::connect_passages(int r1, int r2) {
   }
 
   else {
-    Game::io->message("DEBUG: error in connection tables");
+    // Not a message, this may run on Pregen's thread (see pregen.h)
+    error("Error in connection tables");
   }
 
   /* where turn starts */
@@ -195,32 +181,20 @@ Level::create_passages()
     bool ingraph;         /* this room in graph already? */
   };
 
-  vector<Destination> destinations {
-    { { 0, 1, 0, 1, 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 1, 0, 1, 0, 1, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 0, 1, 0, 0, 0, 1, 0, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 1, 0, 0, 0, 1, 0, 1, 0, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 0, 1, 0, 1, 0, 1, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 0, 0, 1, 0, 1, 0, 0, 0, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 0, 0, 0, 1, 0, 0, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 0, 0, 0, 0, 1, 0, 1, 0, 1 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-    { { 0, 0, 0, 0, 0, 1, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0 }, 0 },
-  };
-
-  if (destinations.size() != 9) {
-    error("Expected 9 rooms in destinations");
-  }
-
-  // reinitialize room graph description
-  for (Destination& ptr : destinations) {
-    if (ptr.isconn.size() != 9) {
-      error("Expected 3 isconns in ptr");
-    }
-
-    for (size_t i = 0; i < ptr.isconn.size(); i++) {
-      ptr.isconn.at(i) = false;
-    }
+  // Rooms can connect to the rooms next to them in the grid
+  size_t const nrooms = rooms.size();
+  size_t const columns = static_cast<size_t>(shape.room_columns);
+  vector<Destination> destinations(nrooms);
+  for (size_t i = 0; i < nrooms; ++i) {
+    Destination& ptr = destinations.at(i);
+    ptr.conn.assign(nrooms, false);
+    ptr.isconn.assign(nrooms, false);
     ptr.ingraph = false;
+
+    if (i % columns != 0)           ptr.conn.at(i - 1) = true;
+    if (i % columns != columns - 1) ptr.conn.at(i + 1) = true;
+    if (i >= columns)               ptr.conn.at(i - columns) = true;
+    if (i + columns < nrooms)       ptr.conn.at(i + columns) = true;
   }
 
   // starting with one room, connect it to a random adjacent room and
@@ -324,8 +298,8 @@ void Level::place_passage(Coordinate* coord) {
 void
 Level::wizard_show_passages() {
 
-  for (int y = 1; y < NUMLINES - 1; y++) {
-    for (int x = 0; x < NUMCOLS; x++) {
+  for (int y = 1; y < shape.height - 1; y++) {
+    for (int x = 0; x < shape.width; x++) {
 
       Tile::Type ch = get_tile(x, y);
 
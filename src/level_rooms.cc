@@ -16,97 +16,57 @@ using namespace std;
 
 #include "level_rooms.h"
 
-/* position matrix for maze positions */
-struct spot {
-  int        nexits;
-  Coordinate exits[4];
-  int        used;
-};
-
-static spot maze[NUMLINES/3+1][NUMCOLS/3+1];
-
-/* Account for maze exits */
-static void
-room_accnt_maze(int y, int x, int ny, int nx) {
-  spot* sp = &maze[y][x];
-  Coordinate* cp;
-
-  for (cp = sp->exits; cp < &sp->exits[sp->nexits]; cp++) {
-    if (cp->y == ny && cp->x == nx) {
-      return;
-    }
-  }
-
-  cp->y = ny;
-  cp->x = nx;
-}
-
-
-/* Dig out from around where we are now, if possible */
+/* Dig out a maze from start, with a depth-first search. Coordinates are
+ * relative to the room, and only even ones are cells */
 void
-Level::draw_maze_recursive(int y, int x, int starty, int startx, int maxy, int maxx) {
-  int nexty = 0;
-  int nextx = 0;
+Level::carve_maze(Coordinate const& start, Coordinate const& room_pos, Coordinate const& room_max) {
+  // Every cell is pushed at most once, so this never reallocates
+  maze_stack.clear();
+  maze_stack.reserve(static_cast<size_t>((room_max.y / 2 + 1) * (room_max.x / 2 + 1)));
+  maze_stack.push_back(start);
+
+  while (!maze_stack.empty()) {
+    Coordinate const cur = maze_stack.back();
+    Coordinate next;
 
-  for (;;) {
     Coordinate const del[4] = { {2, 0}, {-2, 0}, {0, 2}, {0, -2} };
     int cnt = 0;
     for (unsigned i = 0; i < sizeof(del)/sizeof(*del); ++i) {
-      int newy = y + del[i].y;
-      int newx = x + del[i].x;
+      int newy = cur.y + del[i].y;
+      int newx = cur.x + del[i].x;
 
-      if (newy < 0 || newy > maxy || newx < 0 || newx > maxx
-          || is_passage(newx + startx, newy + starty)) {
+      if (newy < 0 || newy > room_max.y || newx < 0 || newx > room_max.x
+          || is_passage(newx + room_pos.x, newy + room_pos.y)) {
         continue;
       }
 
       if (os_rand_range(++cnt) == 0) {
-        nexty = newy;
-        nextx = newx;
+        next.y = newy;
+        next.x = newx;
       }
     }
 
+    // Dead end, go back
     if (cnt == 0) {
-      return;
+      maze_stack.pop_back();
+      continue;
     }
 
-    room_accnt_maze(y, x, nexty, nextx);
-    room_accnt_maze(nexty, nextx, y, x);
-
-    Coordinate pos;
-    if (nexty == y) {
-      pos.y = y + starty;
-      if (nextx - x < 0) {
-        pos.x = nextx + startx + 1;
-      } else {
-        pos.x = nextx + startx - 1;
-      }
-    } else {
-      pos.x = x + startx;
-      if (nexty - y < 0) {
-        pos.y = nexty + starty + 1;
-      } else {
-        pos.y = nexty + starty - 1;
-      }
-    }
+    // Dig the wall between the cells, and the next cell
+    Coordinate pos((cur.x + next.x) / 2 + room_pos.x, (cur.y + next.y) / 2 + room_pos.y);
     place_passage(&pos);
 
-    pos.y = nexty + starty;
-    pos.x = nextx + startx;
+    pos.y = next.y + room_pos.y;
+    pos.x = next.x + room_pos.x;
     place_passage(&pos);
 
-    draw_maze_recursive(nexty, nextx, starty, startx, maxy, maxx);
+    maze_stack.push_back(next);
   }
 }
 
 /* Dig a maze */
 void
 Level::draw_maze(room const& rp) {
-  for (spot* sp = &maze[0][0]; sp <= &maze[NUMLINES / 3][NUMCOLS / 3]; sp++) {
-    sp->used = false;
-    sp->nexits = 0;
-  }
-
   int y = (os_rand_range(rp.r_max.y) / 2) * 2;
   int x = (os_rand_range(rp.r_max.x) / 2) * 2;
 
@@ -114,7 +74,10 @@ Level::draw_maze(room const& rp) {
   Coordinate pos(y + rp.r_pos.x, y + rp.r_pos.y);
   place_passage(&pos);
 
-  draw_maze_recursive(y, x, rp.r_pos.y, rp.r_pos.x, rp.r_max.y, rp.r_max.x);
+  // Mazes dig one past their size, so keep them off the edge of the map
+  Coordinate const limit(min(rp.r_max.x, shape.width - 2 - rp.r_pos.x),
+                         min(rp.r_max.y, shape.height - 2 - rp.r_pos.y));
+  carve_maze(Coordinate(x, y), rp.r_pos, limit);
 }
 
 /* Draw a box around a room and lay down the floor for normal
@@ -140,21 +103,23 @@ Level::draw_room(room const& rp) {
       Tile& t = tile(x, y);
       t.type = Tile::Floor;
       t.is_dark = rp.r_flags & ISDARK;
+      update_cells(x, y);
     }
   }
 }
 
 static void
-room_place_gone_room(Coordinate const* max_size, Coordinate const* top, room* room) {
+room_place_gone_room(Coordinate const* max_size, Coordinate const* top, room* room,
+                     Level::Shape const& shape) {
   /** Place a gone room.  Make certain that there is a blank line
    * for passage drawing.  */
   do {
     room->r_pos.x = top->x + os_rand_range(max_size->x - 3) + 1;
     room->r_pos.y = top->y + os_rand_range(max_size->y - 2) + 1;
-    room->r_max.x = -NUMCOLS;
-    room->r_max.y = -NUMLINES;
-  } while (!(room->r_pos.y > 0 && room->r_pos.y < NUMLINES-1 &&
-             room->r_pos.x > 0 && room->r_pos.x < NUMCOLS -1));
+    room->r_max.x = -shape.width;
+    room->r_max.y = -shape.height;
+  } while (!(room->r_pos.y > 0 && room->r_pos.y < shape.height -1 &&
+             room->r_pos.x > 0 && room->r_pos.x < shape.width -1));
 }
 
 void
@@ -167,29 +132,37 @@ Level::create_rooms() {
     room.r_flags = 0;
   }
 
-  /* Put the gone rooms, if any, on the level */
-  int left_out = os_rand_range(4);
+  /* Put the gone rooms, if any, on the level. Up to 3 out of 9 */
+  int left_out = os_rand_range(4 * static_cast<int>(rooms.size()) / 9);
   for (int i = 0; i < left_out; i++) {
     get_random_room()->r_flags |= ISGONE;
   }
 
   /* dig and populate all the rooms on the level */
-  if (rooms.size() != 9) {
-    error("This functions expects there to be exacly 9 rooms"
+  if (rooms.size() != static_cast<size_t>(shape.room_columns * shape.room_rows)) {
+    error("This functions expects there to be exacly " +
+          to_string(shape.room_columns * shape.room_rows) + " rooms"
           " but currently there are " + to_string(rooms.size()));
   }
 
-  /* maximum room size */
-  Coordinate const bsze(NUMCOLS / 3, NUMLINES / 3);
+  /* Rooms are indexed as they are placed, mazes look them up */
+  room_plane.assign(tiles.size(), no_room);
+  floor_cells.assign(rooms.size(), CellSet());
+  open_cells.assign(rooms.size(), CellSet());
+
+  /* maximum room size. Leave the last column, so walls stay inside the map */
+  Coordinate const bsze((shape.width - 1) / shape.room_columns,
+                        shape.height / shape.room_rows);
 
   for (int i = 0; i < static_cast<int>(rooms.size()); i++) {
     room& room = rooms.at(static_cast<size_t>(i));
 
     /* Find upper left corner of box that this room goes in */
-    Coordinate const top((i % 3) * bsze.x + 1, (i / 3) * bsze.y);
+    Coordinate const top((i % shape.room_columns) * bsze.x + 1,
+                         (i / shape.room_columns) * bsze.y);
 
     if (room.r_flags & ISGONE) {
-      room_place_gone_room(&bsze, &top, &room);
+      room_place_gone_room(&bsze, &top, &room, shape);
       continue;
     }
 
@@ -203,13 +176,15 @@ Level::create_rooms() {
 
     /* Find a place and size for a random room */
     if (room.r_flags & ISMAZE) {
-      room.r_max.x = bsze.x - 1;
-      room.r_max.y = bsze.y - 1;
+      // Odd sizes, so the doors on the right and bottom side are on maze
+      // cells (see connect_passages())
+      room.r_max.x = bsze.x - 1 - (bsze.x % 2);
+      room.r_max.y = bsze.y - 1 - (bsze.y % 2);
       room.r_pos.x = top.x;
       room.r_pos.y = top.y;
       if (room.r_pos.y == 0) {
         room.r_pos.y++;
-        room.r_max.y--;
+        room.r_max.y -= 2;
       } else if (room.r_pos.x == 0) {
         room.r_pos.x++;
         room.r_max.x--;
@@ -224,6 +199,7 @@ Level::create_rooms() {
       } while (room.r_pos.y == 0 || room.r_pos.x == 0);
     }
 
+    index_room(static_cast<size_t>(i));
     if (room.r_flags & ISMAZE) {
       draw_maze(room);
     } else {
@@ -233,54 +209,83 @@ Level::create_rooms() {
     /* Put the monster in */
     if (os_rand_range(100) < (room.r_goldval > 0 ? 80 : 25)) {
       Coordinate mp;
-      get_random_room_coord(&room, &mp, 0, true);
+      if (!get_random_room_coord(&room, &mp, true)) {
+        continue;
+      }
       Monster::Type mon_type = Monster::random_monster_type_for_level();
       Monster* monster = new Monster(mon_type, mp);
-      monsters.push_back(monster);
       monster->give_pack();
-      set_monster(mp, monster);
+      add_monster(monster, 0);
     }
   }
 }
 
 bool
-Level::get_random_room_coord(room* room, Coordinate* coord, int tries, bool monst) {
-  bool limited_tries = tries > 0;
-  char compchar = Tile::Floor;
-  bool pickroom = room == nullptr;
-
-  for (;;) {
-    if (limited_tries && tries-- == 0) {
+Level::get_random_room_coord(room* room, Coordinate* coord, bool monst,
+                             Coordinate const* avoid) {
+  vector<CellSet> const& cells = monst ? open_cells : floor_cells;
+  auto spots = [&cells, avoid] (size_t id) {
+    CellSet const& set = cells.at(id);
+    bool const avoided = avoid != nullptr && set.contains(avoid->x, avoid->y);
+    return set.size() - (avoided ? 1 : 0);
+  };
+
+  // Every room with somewhere to go is as likely, and every spot in it
+  size_t id = 0;
+  if (room == nullptr) {
+    size_t candidates = 0;
+    for (size_t i = 0; i < cells.size(); ++i) {
+      if (spots(i) > 0) {
+        ++candidates;
+      }
+    }
+    if (candidates == 0) {
       return false;
     }
 
-    if (pickroom) {
-      room = get_random_room();
+    size_t n = os_rand_range(candidates);
+    while (spots(id) == 0 || n-- > 0) {
+      ++id;
     }
+  } else {
+    id = static_cast<size_t>(room - rooms.data());
+  }
 
-    /* Pick a random position */
-    coord->x = room->r_pos.x + os_rand_range(room->r_max.x - 2) + 1;
-    coord->y = room->r_pos.y + os_rand_range(room->r_max.y - 2) + 1;
+  size_t const size = spots(id);
+  if (size == 0) {
+    return false;
+  }
 
-    Tile::Type ch = get_tile(*coord);
-    if (monst) {
-      if (get_monster(*coord) == nullptr &&
-          can_step(*coord)) {
-        return true;
-      }
-    } else if (ch == compchar) {
-      return true;
+  // Members are in reading order, so skipping avoid means taking the next
+  // one from there on
+  CellSet const& set = cells.at(id);
+  size_t n = os_rand_range(size);
+  if (size < set.size()) {
+    Coordinate const pos = set.at(n);
+    if (pos.y > avoid->y || (pos.y == avoid->y && pos.x >= avoid->x)) {
+      ++n;
     }
   }
+  *coord = set.at(n);
+  return true;
 }
 
 room* Level::get_random_room() {
-  for (;;) {
-    room* room = &rooms.at(static_cast<size_t>(os_rand_range(rooms.size())));
-    if (room->r_flags & ISGONE) {
-      continue;
+  size_t present = 0;
+  for (struct room const& room : rooms) {
+    if (!(room.r_flags & ISGONE)) {
+      ++present;
     }
+  }
+  if (present == 0) {
+    error("All rooms are gone");
+  }
 
-    return room;
+  size_t n = os_rand_range(present);
+  for (struct room& room : rooms) {
+    if (!(room.r_flags & ISGONE) && n-- == 0) {
+      return &room;
+    }
   }
+  return nullptr;
 }
@@ -11,69 +11,29 @@ using namespace std;
 #include "level.h"
 #include "misc.h"
 #include "monster.h"
+#include "options.h"
 #include "os.h"
 #include "player.h"
+#include "ray.h"
 #include "weapons.h"
 #include "death.h"
 
 #include "magic.h"
 
-static bool
-magic_bolt_handle_bounces(Coordinate& pos, Coordinate* dir, char* dirtile)
+// How a bolt going in dir looks
+static char
+bolt_tile(Coordinate const& dir)
 {
-  int num_bounces = 0;
-recursive_loop:; /* ONLY called by end of function */
-  Monster* monster = Game::level->get_monster(pos);
-  Tile::Type ch = Game::level->get_tile(pos);
-  if (monster != nullptr || ch != Tile::Wall) {
-    return num_bounces != 0;
-  }
-
-  // There are no known bugs with this functions at the moment,
-  // but just in case, we'll abort after too many bounces
-  if (num_bounces > 10) {
-    return true;
-  }
-
-  // Handle potential bouncing
-  if (ch == Tile::Wall) {
-    enum bounce_type_t { Horizontal, Vertical} bounce_type;
-
-    if (dir->x != 0 && dir->y == 0) {
-      bounce_type = Vertical;
-
-    } else if (dir->y != 0 && dir->x == 0) {
-      bounce_type = Horizontal;
-
-    } else {
-      int y = dir->y < 0 ? pos.y + 1 : pos.y - 1;
-      Tile::Type y_ch;
-      if (y >= NUMLINES || y <= 0)
-        y_ch = Tile::Wall;
-      else
-        y_ch = Game::level->get_tile(pos.x, y);
-
-      bounce_type = y_ch == Tile::Wall ? Vertical : Horizontal;
-    }
-
-    if (bounce_type == Vertical) {
-      pos.x -= dir->x;
-      dir->x = -dir->x;
-    } else {
-      pos.y -= dir->y;
-      dir->y = -dir->y;
-    }
+  switch (dir.y + dir.x)
+  {
+    case 0: return IO::DiagonalUpBolt;
+    case 1: case -1:
+      return dir.y == 0
+          ? IO::HorizontalBolt
+          : IO::VerticalBolt;
+    case 2: case -2: return IO::DiagonalDownBolt;
   }
-
-  if (*dirtile == IO::DiagonalDownBolt)
-    *dirtile = IO::DiagonalUpBolt;
-  else if (*dirtile == IO::DiagonalUpBolt)
-    *dirtile = IO::DiagonalDownBolt;
-
-  /* It's possible for a bolt to bounce directly from one wall to another
-   * if you hit a corner, thus, we need to go through everything again. */
-  ++num_bounces;
-  goto recursive_loop; /* == magic_bolt_handle_bounces(pos,dir,dirtile) */
+  return '?';
 }
 
 static void
@@ -149,29 +109,19 @@ magic_bolt(Coordinate* start, Coordinate* dir, string const& name)
     error("dir was null");
   }
 
-  char dirtile = '?';
-  switch (dir->y + dir->x)
-  {
-    case 0: dirtile = IO::DiagonalUpBolt; break;
-    case 1: case -1:
-      dirtile = (dir->y == 0
-          ? IO::HorizontalBolt
-          : IO::VerticalBolt);
-      break;
-    case 2: case -2: dirtile = IO::DiagonalDownBolt; break;
-  }
-
   IO::Attribute color = IO::Attribute::Red;
   if (name == "ice") {
     color = IO::Attribute::Blue;
   }
 
-  Coordinate pos = *start;
-  for (int i = 0; i < BOLT_LENGTH; ++i) {
-    pos.y += dir->y;
-    pos.x += dir->x;
+  // Where it goes only depends on the walls, so it can be found up front
+  Ray::Path path;
+  Ray::bounce(*start, *dir, BOLT_LENGTH, path);
+
+  for (Ray::Cell const& cell : path.cells) {
+    Coordinate pos = cell.pos;
 
-    if (magic_bolt_handle_bounces(pos, dir, &dirtile))
+    if (cell.bounced)
       Game::io->message("the " + name + " bounces");
 
     /* Handle potential hits */
@@ -183,11 +133,12 @@ magic_bolt(Coordinate* start, Coordinate* dir, string const& name)
       magic_bolt_hit_monster(tp, start, &pos, name);
     }
 
-    Game::io->print(pos.x, pos.y, dirtile, color);
+    if (animation != Animation::Off) {
+      Game::io->print(pos.x, pos.y, bolt_tile(cell.dir), color);
+    }
   }
 
-  refresh();
-  os_usleep(200000);
+  io_animation_frame(200000);
 }
 
 
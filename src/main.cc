@@ -1,8 +1,11 @@
 #include <getopt.h>
+#include <unistd.h>
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 
+#include "broadcast.h"
 #include "error_handling.h"
 #include "game.h"
 #include "command.h"
@@ -13,8 +16,11 @@
 #include "player.h"
 #include "options.h"
 #include "os.h"
+#include "profile.h"
 #include "move.h"
+#include "replay.h"
 #include "rogue.h"
+#include "server.h"
 #include "wizard.h"
 
 using namespace std;
@@ -22,7 +28,10 @@ using namespace std;
 
 // Parse command-line arguments
 static void
-parse_args(int argc, char* const* argv, bool& restore, string& save_path, string& whoami)
+parse_args(int argc, char* const* argv, bool& restore, string& save_path, string& whoami,
+           string& record_path, string& replay_path, int& replay_speed,
+           string& profile_path, string& serve_path, string& connect_path,
+           string& broadcast_path, string& watch_path)
 {
   string const game_version = "Misty Mountains v2.0-alpha2 - Based on Rogue5.4.4";
   int option_index = 0;
@@ -40,6 +49,21 @@ parse_args(int argc, char* const* argv, bool& restore, string& save_path, string
     {"wizard",    no_argument,       0, 'W'},
     {"help",      no_argument,       0, '0'},
     {"dicerolls", no_argument,       0,  1 },
+    {"record",    required_argument, 0,  2 },
+    {"replay",    required_argument, 0,  3 },
+    {"speed",     required_argument, 0,  4 },
+    {"max",       no_argument,       0,  5 },
+    {"animation", required_argument, 0,  6 },
+    {"map",       required_argument, 0,  7 },
+    {"rooms",     required_argument, 0,  8 },
+    {"profile",   required_argument, 0,  9 },
+    {"history",   required_argument, 0, 10 },
+    {"no-more",   no_argument,       0, 11 },
+    {"serve",     required_argument, 0, 12 },
+    {"connect",   required_argument, 0, 13 },
+    {"broadcast", required_argument, 0, 14 },
+    {"watch",     required_argument, 0, 15 },
+    {"hibernate", required_argument, 0, 16 },
     {"version",   no_argument,       0, '1'},
     {0,           0,                 0,  0 }
   };
@@ -73,7 +97,7 @@ parse_args(int argc, char* const* argv, bool& restore, string& save_path, string
           save_path = optarg;
         }
       } break;
-      case 's': score_show_and_exit(0, -1, 0); // does not return
+      case 's': score_show(); exit(0);
       case 'W': wizard = true; break;
       case 'S': if (wizard && optarg != nullptr) {
                   os_rand_seed = static_cast<unsigned>(stoul(optarg));
@@ -81,6 +105,62 @@ parse_args(int argc, char* const* argv, bool& restore, string& save_path, string
       case   1: if (wizard) {
                   wizard_dicerolls = true;
                 } break;
+      case   2: record_path = optarg; break;
+      case   3: replay_path = optarg; break;
+      case   4: replay_speed = atoi(optarg); break;
+      case   5: replay_speed = 0; animation = Animation::Off; break;
+      case   6: {
+        string const policy = optarg;
+        if (policy == "off") {
+          animation = Animation::Off;
+        } else if (policy == "instant") {
+          animation = Animation::Instant;
+        } else if (policy == "timed") {
+          animation = Animation::Timed;
+        } else {
+          cerr << argv[0] << ": animation must be off, instant or timed\n";
+          exit(1);
+        }
+      } break;
+      case   7: case 8: {
+        int first = 0;
+        int second = 0;
+        char separator = 0;
+        char rest = 0;
+        if (sscanf(optarg, "%d%c%d%c", &first, &separator, &second, &rest) != 3 ||
+            separator != 'x') {
+          cerr << argv[0] << ": " << (c == 7 ? "map" : "rooms")
+               << " must be given as NUMxNUM\n";
+          exit(1);
+        }
+        if (c == 7) {
+          Game::level_shape.width = first;
+          Game::level_shape.height = second;
+        } else {
+          Game::level_shape.room_columns = first;
+          Game::level_shape.room_rows = second;
+        }
+      } break;
+      case   9: profile_path = optarg; break;
+      case  10: {
+        message_history = atoi(optarg);
+        if (message_history < 1) {
+          cerr << argv[0] << ": history must be at least 1 line\n";
+          exit(1);
+        }
+      } break;
+      case  11: batch_messages = true; break;
+      case  12: serve_path = optarg; break;
+      case  13: connect_path = optarg; break;
+      case  14: broadcast_path = optarg; break;
+      case  15: watch_path = optarg; break;
+      case  16: {
+        hibernate_after = atoi(optarg);
+        if (hibernate_after < 1) {
+          cerr << argv[0] << ": hibernate needs at least 1 second\n";
+          exit(1);
+        }
+      } break;
       case '0':
         cout << "Usage: " << argv[0] << " [OPTIONS] [FILE]\n"
              << "Run Rogue14 with selected options or a savefile\n\n"
@@ -97,6 +177,31 @@ parse_args(int argc, char* const* argv, bool& restore, string& save_path, string
              << "  -W, --wizard         run the game in debug-mode\n"
              << "      --dicerolls      (wizard) show all dice rolls\n"
              << "  -S, --seed=NUMBER    (wizard) set map seed to NUMBER\n"
+             << "      --record=FILE    record all keypresses to FILE\n"
+             << "      --replay=FILE    replay a game recorded with --record\n"
+             << "      --speed=NUM      replay NUM keypresses per second\n"
+             << "      --max            replay as fast as possible, without\n"
+             << "                       animations\n"
+             << "      --animation=WHEN show missiles, bolts and running: off,\n"
+             << "                       instant or timed (default)\n"
+             << "      --map=WxH        make levels W columns wide and H lines\n"
+             << "                       high (default 80x24)\n"
+             << "      --rooms=CxR      lay out rooms in C columns and R rows\n"
+             << "                       (default 3x3)\n"
+             << "      --history=NUM    remember NUM lines of messages for ^P\n"
+             << "                       (default 200)\n"
+             << "      --no-more        never wait for a key at --More--, messages\n"
+             << "                       that don't fit are only kept for ^P\n"
+             << "      --serve=SOCKET   serve games to clients connecting to SOCKET,\n"
+             << "                       in a process each\n"
+             << "      --connect=SOCKET play on the server listening on SOCKET\n"
+             << "      --broadcast=SOCKET let others watch the game on SOCKET\n"
+             << "      --watch=SOCKET   watch a game broadcast on SOCKET, or\n"
+             << "                       served as NAME on SOCKET.NAME\n"
+             << "      --hibernate=SECS write the game to disk and free its memory\n"
+             << "                       after SECS seconds without a key\n"
+             << "      --profile=FILE   write time spent per turn to FILE on exit\n"
+             << "                       (needs a `make profile` build)\n"
              << "      --help           display this help and exit\n"
              << "      --version        display game version and exit\n\n"
              << game_version
@@ -118,6 +223,21 @@ parse_args(int argc, char* const* argv, bool& restore, string& save_path, string
   }
 }
 
+// Restore the game at save_path, or start a new one
+static Game*
+start_game(bool restore, string const& save_path, string const& whoami)
+{
+  if (!restore) {
+    return new Game(whoami, save_path);
+  }
+
+  ifstream savefile(save_path);
+  Game* game = new Game(savefile);
+  savefile.close();
+  remove(save_path.c_str());
+  return game;
+}
+
 /** main:
  * The main program, of course */
 int
@@ -129,9 +249,81 @@ main(int argc, char** argv)
   bool   restore = false;
   string save_path;
   string whoami;
+  string record_path;
+  string replay_path;
+  int    replay_speed = 20;
+  string profile_path;
+  string serve_path;
+  string connect_path;
+  string broadcast_path;
+  string watch_path;
 
   /* Parse args and then init new (or old) game */
-  parse_args(argc, argv, restore, save_path, whoami);
+  parse_args(argc, argv, restore, save_path, whoami,
+             record_path, replay_path, replay_speed, profile_path,
+             serve_path, connect_path, broadcast_path, watch_path);
+
+  if (restore && (!record_path.empty() || !replay_path.empty())) {
+    cerr << "Cannot record or replay a restored game\n";
+    return 1;
+  }
+
+  if (!watch_path.empty()) {
+    return Broadcast::watch(watch_path);
+  }
+
+  if (!connect_path.empty()) {
+    if (whoami.empty()) {
+      whoami = os_whoami();
+    }
+    if (!Server::valid_name(whoami)) {
+      cerr << "Names may only have letters, digits, '.', '-' and '_'\n";
+      return 1;
+    }
+    return Server::connect(connect_path, whoami);
+  }
+
+  if (!serve_path.empty()) {
+    if (restore || !record_path.empty() || !replay_path.empty()) {
+      cerr << "Cannot record, replay or restore games in server mode\n";
+      return 1;
+    }
+
+    // Returns in the session for a new client. Each player has a savefile
+    // of their own, so a session that was left is picked up again
+    if (!Server::serve(serve_path, whoami)) {
+      cerr << serve_path + ": " + strerror(errno) + "\n";
+      return 1;
+    }
+    save_path = os_homedir() + ".misty_mountain." +
+      to_string(Server::session_uid()) + "." + whoami + ".save";
+    restore = access(save_path.c_str(), R_OK) == 0;
+    broadcast_path = serve_path + "." + whoami;
+  }
+
+  // Another user may be playing under the same name. Their game keeps the
+  // socket, and this one is just not broadcast
+  if (!broadcast_path.empty() && !Broadcast::start(broadcast_path) &&
+      !Server::in_session()) {
+    cerr << broadcast_path + ": " + strerror(errno) + "\n";
+    return 1;
+  }
+
+  if (!replay_path.empty() && !Replay::start_replay(replay_path, replay_speed)) {
+    cerr << replay_path + ": not a valid replay file\n";
+    return 1;
+  }
+
+  string const shape_error = Level::check_shape(Game::level_shape);
+  if (!shape_error.empty()) {
+    cerr << shape_error + "\n";
+    return 1;
+  }
+
+  if (!record_path.empty() && !Replay::start_recording(record_path)) {
+    cerr << record_path + ": " + strerror(errno) + "\n";
+    return 1;
+  }
 
   if (whoami.empty()) {
     whoami = os_whoami();
@@ -141,27 +333,32 @@ main(int argc, char** argv)
     save_path = os_homedir() + ".misty_mountain.save";
   }
 
+  if (restore && access(save_path.c_str(), R_OK) != 0) {
+    cerr << save_path + ": " + strerror(errno) + "\n";
+    return 1;
+  }
 
+  // Starting the game can fail too, like when the screen is too small
   Game* game = nullptr;
-  if (restore) {
-    ifstream savefile(save_path);
-    if (!savefile) {
-      cerr << save_path + ": " + strerror(errno) + "\n";
-      return 1;
-    }
-
-    game = new Game(savefile);
-    savefile.close();
-    remove(save_path.c_str());
-  } else {
-    game = new Game(whoami, save_path);
+#ifdef NDEBUG
+  try {
+    game = start_game(restore, save_path, whoami);
+    game->run();
+  } catch (const std::runtime_error &ex) {
+    endwin();
+    cout << ex.what() << endl;
+    return 1;
   }
+#else
+  game = start_game(restore, save_path, whoami);
+  game->run();
+#endif
 
-
-  if (game != nullptr) {
-    return game->run();
+  if (!profile_path.empty() && !Profile::dump(profile_path)) {
+    cerr << profile_path + ": " + strerror(errno) + "\n";
   }
 
+  delete game;
   return 0;
 }
 
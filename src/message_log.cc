@@ -0,0 +1,47 @@
+#include "error_handling.h"
+
+#include "message_log.h"
+
+using namespace std;
+
+MessageLog::MessageLog(size_t lines_, size_t line_length)
+  : line_size(line_length + 1), lines(lines_), newest(0), count(0),
+    slots(lines_ * (line_length + 1), '\0') {
+
+  if (lines == 0) {
+    error("MessageLog must hold at least one line");
+  }
+}
+
+void MessageLog::push(string const& line) {
+  newest = (newest + 1) % lines;
+  if (count < lines) {
+    ++count;
+  }
+  replace_newest(line);
+}
+
+void MessageLog::replace_newest(string const& line) {
+  if (count == 0) {
+    push(line);
+    return;
+  }
+
+  size_t const length = line.copy(&slots.at(newest * line_size), line_size - 1);
+  slots.at(newest * line_size + length) = '\0';
+}
+
+size_t MessageLog::size() const {
+  return count;
+}
+
+size_t MessageLog::capacity() const {
+  return lines;
+}
+
+char const* MessageLog::at(size_t i) const {
+  if (i >= count) {
+    error("MessageLog index " + to_string(i) + " out of range");
+  }
+  return &slots.at(((newest + lines - i) % lines) * line_size);
+}
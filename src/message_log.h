@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The last lines shown on the message line, for IO::repeat_last_messages()
+//
+// Lines are copied into slots allocated up front, and the oldest slot is
+// reused when the log is full, so logging a message never allocates.
+// Lines longer than line_length are cut.
+class MessageLog {
+public:
+  MessageLog(size_t lines, size_t line_length);
+
+  // Log a new line
+  void push(std::string const& line);
+
+  // Overwrite the newest line, e.g. when more was added to the message line
+  void replace_newest(std::string const& line);
+
+  // Number of lines logged, at most capacity()
+  size_t size() const;
+  size_t capacity() const;
+
+  // Line i, where 0 is the newest
+  char const* at(size_t i) const;
+
+private:
+  size_t            line_size;  // line_length + nul
+  size_t            lines;
+  size_t            newest;
+  size_t            count;
+  std::vector<char> slots;
+};
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -6,6 +7,7 @@
 #include "magic.h"
 #include "command.h"
 #include "daemons.h"
+#include "disk.h"
 #include "error_handling.h"
 #include "game.h"
 #include "io.h"
@@ -18,7 +20,9 @@
 #include "os.h"
 #include "armor.h"
 #include "options.h"
+#include "profile.h"
 #include "rogue.h"
+#include "scheduler.h"
 #include "death.h"
 
 #include "monster.h"
@@ -226,6 +230,50 @@ static int extra_experience(int level, int max_health) {
 
 Monster::~Monster() {}
 
+Monster::Monster(Monster const& other) :
+  Character(other), t_pack(),
+  disguise(other.disguise), subtype(other.subtype), speed(other.speed),
+  target(other.target) {
+
+  for (Item* item : other.t_pack) {
+    t_pack.push_back(item->clone());
+  }
+}
+
+// Loading must not roll any dice, so the game goes on the same after it
+Monster::Monster(std::istream& data) :
+  Character(0, 0, 0, 0, 0, {}, Coordinate(0, 0), 0, ' '),
+  t_pack(), disguise(' '), subtype(Bat), speed(0),
+  target(Target::nothing()) {
+
+  if (!load(data)) {
+    error("Monster tag error");
+  }
+}
+
+void Monster::save(std::ostream& data) const {
+  Character::save(data);
+  Disk::save_tag(TAG_MONSTER, data);
+  Disk::save(TAG_MONSTER, t_pack, data);
+  Disk::save(TAG_MONSTER, disguise, data);
+  Disk::save(TAG_MONSTER, static_cast<int>(subtype), data);
+  Disk::save(TAG_MONSTER, speed, data);
+}
+
+bool Monster::load(std::istream& data) {
+  int loaded_subtype = 0;
+  if (!Character::load(data) ||
+      !Disk::load_tag(TAG_MONSTER, data) ||
+      !Disk::load(TAG_MONSTER, t_pack, data) ||
+      !Disk::load(TAG_MONSTER, disguise, data) ||
+      !Disk::load(TAG_MONSTER, loaded_subtype, data) ||
+      !Disk::load(TAG_MONSTER, speed, data)) {
+    return false;
+  }
+  subtype = static_cast<Type>(loaded_subtype);
+  return true;
+}
+
 Monster::Monster(Monster::Type subtype_, Coordinate const& pos) :
   Monster(pos, monster_data(subtype_))
 {}
@@ -234,27 +282,55 @@ Monster::Monster(Coordinate const& pos, Template const& m_template) :
   Character(10, m_template.m_basexp, m_template.m_level, m_template.m_armor,
             roll(m_template.m_level, 8), m_template.m_dmg, pos,
             m_template.m_flags, m_template.m_char),
-  t_pack(), turns_not_moved(0), disguise(m_template.m_char),
-  subtype(m_template.m_subtype), speed(m_template.m_speed), target(nullptr) {
+  t_pack(), disguise(m_template.m_char),
+  subtype(m_template.m_subtype), speed(m_template.m_speed), target(Target::nothing()) {
 
   // All monsters are equal, but some monsters are more equal than others, so
   // they also give more experience
   gain_experience(extra_experience(get_level(), get_max_health()));
 
-  if (player != nullptr && player->has_ring_with_ability(Ring::AggravateMonsters)) {
-    monster_start_running(&pos);
-  }
-
   if (subtype == Monster::Xeroc) {
     disguise = rnd_thing();
   }
 }
 
-void Monster::set_target(Coordinate const* new_target) {
+Target Target::nothing() {
+  return { Kind::None, 0 };
+}
+
+Target Target::player() {
+  return { Kind::Player, 0 };
+}
+
+Target Target::item(Item const& item) {
+  return { Kind::Item, item.get_floor_id() };
+}
+
+bool Target::operator==(Target const& other) const {
+  return kind == other.kind && floor_id == other.floor_id;
+}
+
+bool Target::operator!=(Target const& other) const {
+  return !(*this == other);
+}
+
+Coordinate const* Target::position() const {
+  switch (kind) {
+    case Kind::None: return nullptr;
+    case Kind::Player: return &::player->get_position();
+    case Kind::Item: {
+      Item const* item = Game::level->get_item_by_id(floor_id);
+      return item == nullptr ? nullptr : &item->get_position();
+    }
+  }
+  return nullptr;
+}
+
+void Monster::set_target(Target const& new_target) {
   target = new_target;
 }
 
-Coordinate const* Monster::get_target() const {
+Target const& Monster::get_target() const {
   return target;
 }
 
@@ -268,9 +344,10 @@ void Monster::notice_player() {
   if (!is_chasing() && is_mean() && !is_held() && !player->is_stealthy() &&
       !os_rand_range(3)) {
 
-    set_target(&player->get_position());
+    set_target(Target::player());
     if (!is_stuck()) {
       set_chasing();
+      Game::level->wake_monster(this);
     }
   }
 
@@ -357,6 +434,7 @@ monster_start_running(Coordinate const* runner)
   if (!tp->is_stuck()) {
     tp->set_not_held();
     tp->set_chasing();
+    Game::level->wake_monster(tp);
   }
 }
 
@@ -417,8 +495,7 @@ monster_remove_from_screen(Monster** monster_ptr, bool was_killed)
   monster->t_pack.clear();
 
   Coordinate position = monster->get_position();
-  Game::level->set_monster(position, nullptr);
-  Game::level->monsters.remove(monster);
+  Game::level->remove_monster(monster);
 
   Game::io->print_tile(position.x, position.y);
   if (monster->is_players_target()) {
@@ -441,12 +518,14 @@ monster_teleport(Monster* monster, Coordinate const* destination)
 
   /* Select destination */
   Coordinate new_pos;
-  if (destination == nullptr)
-    do
-      Game::level->get_random_room_coord(nullptr, &new_pos, 0, true);
-    while (new_pos == monster->get_position());
-  else
+  if (destination == nullptr) {
+    if (!Game::level->get_random_room_coord(nullptr, &new_pos, true,
+                                            &player->get_position())) {
+      return;
+    }
+  } else {
     new_pos = *destination;
+  }
 
   Game::level->set_monster(monster->get_position(), nullptr);
 
@@ -572,48 +651,58 @@ monster_do_special_ability(Monster** monster_ptr)
 bool
 monster_is_anyone_seen_by_player(void)
 {
-  for (Monster* mon : Game::level->monsters) {
-    if (player->can_see(*mon)) {
-      return true;
+  // Player::can_see() gives up past 2 tiles, so only look that far
+  Coordinate const& player_pos = player->get_position();
+  for (int y = max(player_pos.y - 2, 0);
+       y <= min(player_pos.y + 2, Game::level->get_height() - 1); ++y) {
+    for (int x = max(player_pos.x - 2, 0);
+         x <= min(player_pos.x + 2, Game::level->get_width() - 1); ++x) {
+      Monster* mon = Game::level->get_monster(x, y);
+      if (mon != nullptr && player->can_see(*mon)) {
+        return true;
+      }
     }
   }
   return false;
 }
 
 void Monster::all_move() {
-
-  // This function needs a manual loop, since monsters can die
-  auto it = Game::level->monsters.begin();
-  while (it != Game::level->monsters.end()) {
-    Monster* mon = *it++;
-
-    // Speed < 0 means one move each x turns
-    int speed = mon->get_speed();
-    if (speed < 0) {
-      if (mon->turns_not_moved >= -speed) {
-        mon->turns_not_moved = 0;
-        speed = 1;
-      } else {
-        ++mon->turns_not_moved;
-      }
+  PROFILE_SCOPE(MonstersMove);
+
+  // Only awake monsters due this turn come out of the queue. Those which
+  // were not around to act when they were due (like on a level the player
+  // just came to) act as if they were due now. Monsters which fall asleep
+  // leave the queue until something wakes them (see Level::wake_monster())
+  long long const turn_start = Schedule::turn_start();
+  long long const turn_end = turn_start + Schedule::ticks_per_turn;
+  vector<Monster*> due;
+  Game::level->schedule.list_due(turn_end, due);
+  plan_turns(due);
+
+  long long tick = 0;
+  Monster* mon;
+  while ((mon = Game::level->schedule.pop(turn_end, tick)) != nullptr) {
+    tick = max(tick, turn_start);
+    bool wastarget = mon->is_players_target();
+    Coordinate orig_pos = mon->get_position();
+
+    if (!mon->take_turn()) {
+      // Monster is dead, and off the level
+      continue;
     }
 
-    // One move per turn
-    for (int i = 0; i < speed; ++i) {
-      bool wastarget = mon->is_players_target();
-      Coordinate orig_pos = mon->get_position();
-
-      if (!mon->take_turn()) {
-        // Monster is dead
-        break;
-      }
+    if (wastarget && !(orig_pos == mon->get_position())) {
+      mon->set_not_players_target();
+      to_death = false;
+    }
 
-      if (wastarget && !(orig_pos == mon->get_position())) {
-        mon->set_not_players_target();
-        to_death = false;
-      }
+    // It may have been woken again while it acted
+    Game::level->schedule.remove(mon);
+    if (mon->is_awake()) {
+      Game::level->schedule.push(mon, tick + Schedule::delay(mon->get_speed()));
     }
   }
+  forget_plans();
 }
 
 void
@@ -628,8 +717,8 @@ void
 monster_aggro_all_which_desire_item(Item* item)
 {
   for (Monster* mon : Game::level->monsters) {
-    if (mon->get_target() == &item->get_position()) {
-      mon->set_target(&player->get_position());
+    if (mon->get_target() == Target::item(*item)) {
+      mon->set_target(Target::player());
     }
   }
 }
@@ -680,7 +769,7 @@ monster_show_if_magic_inventory(void)
       {
         Coordinate pos = mon->get_position();
         atleast_one = true;
-        mvwaddcch(Game::io->extra_screen, pos.y, pos.x, IO::Magic);
+        Game::io->print_extra(pos.x, pos.y, IO::Magic);
       }
     }
   }
@@ -739,6 +828,7 @@ monster_polymorph(Monster* target)
 
   // Put back some saved things from old monster
   target->t_pack = target_pack;
+  Game::level->wake_monster(target);
 }
 
 bool monster_try_breathe_fire_on_player(Monster const& monster) {
@@ -776,25 +866,27 @@ int Monster::get_speed() const {
   return speed;
 }
 
+bool Monster::is_awake() const {
+  return is_chasing() || is_mean();
+}
+
 void Monster::increase_speed() {
   if (++speed == 0) {
     speed = 1;
   }
-  turns_not_moved = 0;
 }
 
 void Monster::decrease_speed() {
-  if (--speed) {
+  if (--speed == 0) {
     speed = -1;
   }
-  turns_not_moved = 0;
 }
 
 void Monster::find_new_target()
 {
   int prob = monster_data(subtype).m_carry;
   if (prob <= 0 || player->can_see(*this)) {
-    set_target(&player->get_position());
+    set_target(Target::player());
     return;
   }
 
@@ -802,23 +894,23 @@ void Monster::find_new_target()
     if (obj->o_type == IO::Scroll && obj->o_which == Scroll::SCARE)
       continue;
 
-    if (Game::level->get_room(obj->get_position()) == 
-        Game::level->get_room(get_position()) &&
+    if (Game::level->get_room_id(obj->get_position()) ==
+        Game::level->get_room_id(get_position()) &&
         os_rand_range(100) < prob)
     {
       auto result = find_if(Game::level->monsters.cbegin(), Game::level->monsters.cend(),
           [&] (Monster const* m) {
-          return m->get_target() == &obj->get_position();
+          return m->get_target() == Target::item(*obj);
       });
 
       if (result == Game::level->monsters.cend()) {
-        set_target(&obj->get_position());
+        set_target(Target::item(*obj));
         return;
       }
     }
   }
 
-  set_target(&player->get_position());
+  set_target(Target::player());
 }
 
 Monster::Type Monster::get_subtype() const {
@@ -9,6 +9,26 @@
 #include "item.h"
 #include "rogue.h"
 
+// What a monster is going for. Items are kept by their floor id (see
+// Level::add_item()) rather than by pointer, so a target stays good when the
+// level is copied, and goes away when the item leaves the floor
+struct Target {
+  enum class Kind { None, Player, Item };
+
+  static Target nothing();
+  static Target player();
+  static Target item(Item const& item);
+
+  bool operator==(Target const& other) const;
+  bool operator!=(Target const& other) const;
+
+  // Where the target is now, or nullptr if there is none or it's gone
+  Coordinate const* position() const;
+
+  Kind               kind;
+  unsigned long long floor_id;  // If kind is Item
+};
+
 class Monster : public Character {
 public:
   enum Type {
@@ -37,7 +57,8 @@ public:
 
 
   Monster(Type subtype, Coordinate const& pos);
-  Monster(Monster const&) = delete; // Deleted since they would share inventory
+  Monster(Monster const&); // Copies inventory as well
+  explicit Monster(std::istream&); // Everything but the target, see Level
 
   ~Monster();
 
@@ -46,7 +67,7 @@ public:
 
   // Setters
   void set_invisible() override;
-  void set_target(Coordinate const* target);
+  void set_target(Target const& target);
   void set_disguise(char);
 
   // Modifiers
@@ -58,6 +79,11 @@ public:
 
   // monster_chase.c
   bool take_turn(); // True if monster is still alive
+  // Find where monsters could step this turn ahead of time, on worker threads
+  // if there are enough of them. take_turn() uses the plans which are still
+  // good, until forget_plans()
+  static void plan_turns(std::vector<Monster*> const& monsters);
+  static void forget_plans();
 
   // Getters
   int               get_armor() const override;
@@ -65,9 +91,13 @@ public:
   std::string       get_name() const override;
   char              get_disguise() const;
   int               get_speed() const;
-  Coordinate const* get_target() const;
+  bool              is_awake() const;  // Chasing or mean, else take_turn() does nothing
+  Target const&     get_target() const;
   Type              get_subtype() const;
 
+  void save(std::ostream&) const override;
+  bool load(std::istream&) override;
+
   // Statics
   static void                 init_monsters();
   static void                 free_monsters();
@@ -80,16 +110,16 @@ public:
   // Variables (TODO: Make these private)
   std::list<Item*>   t_pack;    // What the thing is carrying
 
-  int                turns_not_moved;
-
 private:
   char               disguise;
   Type               subtype;
   int                speed;
-  Coordinate const*  target;
+  Target             target;
 
   static std::vector<Template> const* monsters;
 
+  static unsigned long long constexpr TAG_MONSTER = 0xe000000000000000ULL;
+
   Monster(Coordinate const& pos, Template const& m_template);
 };
 
@@ -1,4 +1,8 @@
+#include <algorithm>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "error_handling.h"
 #include "game.h"
@@ -16,11 +20,149 @@
 #include "rogue.h"
 #include "os.h"
 #include "magic.h"
+#include "workers.h"
 
 #include "monster.h"
 
 using namespace std;
 
+// Where chase() could step, found before the monster's turn. Finding the
+// steps only reads the level, so Monster::plan_turns() does it for many
+// monsters at once on the worker threads (see workers.h). chase() then rolls its dice over the
+// planned steps in the same order as over steps it finds itself, so the game
+// goes the same either way.
+//
+// Plans are only good as long as nothing they looked at has changed. Monsters
+// which just step somewhere mark the tiles they left and entered, and plans
+// next to those are found again. Anything else a monster does (fighting,
+// breathing fire, picking things up, traps) could change anything, so all
+// plans are dropped
+struct Step {
+  Coordinate coord;
+  int        distance;  // To the target, see dist_cp()
+};
+
+struct Plan {
+  Coordinate   from;
+  Coordinate   target;
+  vector<Step> steps;
+};
+
+// A plan takes about 220ns and handing out a part of them about 4us, so
+// fewer than this would be faster on one thread
+static size_t constexpr min_plans_per_thread = 32;
+
+static unordered_map<Monster const*, Plan> plans;
+static unordered_set<int>                  disturbed;  // y * width + x
+static vector<Step>                        found_steps;  // Scratch space for chase()
+
+// Where monster could step to get to target, as chase() looks at them
+static void find_steps(Monster const& monster, Coordinate const& target,
+                       vector<Step>& steps) {
+  Coordinate const& mon_pos = monster.get_position();
+  Coordinate xy;
+  int const max_x = Game::level->get_width() -1;
+  int const max_y = Game::level->get_height() -2;
+  for (xy.x = max(mon_pos.x - 1, 0); xy.x <= min(mon_pos.x + 1, max_x); xy.x++) {
+    for (xy.y = max(mon_pos.y - 1, 0); xy.y <= min(mon_pos.y + 1, max_y); xy.y++) {
+
+      if (Game::level->can_step(xy.x, xy.y)) {
+
+        // Cannot walk on a scare monster scroll
+        Item* xy_item = Game::level->get_item(xy.x, xy.y);
+        if (xy_item != nullptr && xy_item->o_type == IO::Scroll &&
+            xy_item->o_which == Scroll::SCARE) {
+          continue;
+        }
+
+        // It can also be a Xeroc, which we shouldn't step on
+        Monster* obj = Game::level->get_monster(xy.x, xy.y);
+        if (obj != nullptr && obj->get_type() == 'X') {
+          continue;
+        }
+
+        steps.push_back({ xy, dist_cp(&xy, &target) });
+      }
+    }
+  }
+}
+
+// Where take_turn() will chase monster to, if it does
+static Coordinate const* chase_target(Monster const& monster) {
+  if (monster.is_held()) {
+    return nullptr;
+  } else if (!monster.is_chasing() || monster.get_target().position() == nullptr) {
+    return monster.is_mean() ? &player->get_position() : nullptr;
+  }
+
+  room const* chaser_room = Game::level->get_room(monster.get_position());
+  if (monster.is_greedy() && chaser_room != nullptr && chaser_room->r_goldval == 0) {
+    return &player->get_position();
+  }
+  return monster.get_target().position();
+}
+
+// Planned steps for monster going to target, or nullptr if they are stale
+static vector<Step> const* planned_steps(Monster const& monster, Coordinate const& target) {
+  auto it = plans.find(&monster);
+  if (it == plans.end() ||
+      it->second.from != monster.get_position() || it->second.target != target) {
+    return nullptr;
+  }
+
+  int const width = Game::level->get_width();
+  Coordinate const& from = it->second.from;
+  for (int y = from.y - 1; y <= from.y + 1; ++y) {
+    for (int x = from.x - 1; x <= from.x + 1; ++x) {
+      if (disturbed.count(y * width + x) != 0) {
+        return nullptr;
+      }
+    }
+  }
+  return &it->second.steps;
+}
+
+static void disturb(Coordinate const& coord) {
+  if (!plans.empty()) {
+    disturbed.insert(coord.y * Game::level->get_width() + coord.x);
+  }
+}
+
+void Monster::plan_turns(vector<Monster*> const& monsters) {
+  forget_plans();
+
+  size_t const parts = min(Workers::count(), monsters.size() / min_plans_per_thread);
+  if (parts < 2) {
+    return;
+  }
+
+  // Every part fills in its own plans, so they share nothing they write
+  vector<Plan> planned(monsters.size());
+  vector<char> has_plan(monsters.size(), false);
+  Workers::run(parts, [&] (size_t part) {
+    for (size_t i = part; i < monsters.size(); i += parts) {
+      Coordinate const* target = chase_target(*monsters.at(i));
+      if (target != nullptr) {
+        has_plan.at(i) = true;
+        planned.at(i).from = monsters.at(i)->get_position();
+        planned.at(i).target = *target;
+        find_steps(*monsters.at(i), *target, planned.at(i).steps);
+      }
+    }
+  });
+
+  for (size_t i = 0; i < monsters.size(); ++i) {
+    if (has_plan.at(i)) {
+      plans[monsters.at(i)] = move(planned.at(i));
+    }
+  }
+}
+
+void Monster::forget_plans() {
+  plans.clear();
+  disturbed.clear();
+}
+
 // Find the spot for the chaser(er) to move closer to the chasee(ee).
 static Coordinate chase(Monster& monster, Coordinate const& target) {
 
@@ -47,39 +189,26 @@ static Coordinate chase(Monster& monster, Coordinate const& target) {
   Coordinate retval = mon_pos;
   int plcnt = 1;
 
-  Coordinate xy;
-  for (xy.x = max(mon_pos.x - 1, 0); xy.x <= min(mon_pos.x + 1, NUMCOLS -1); xy.x++) {
-    for (xy.y = max(mon_pos.y - 1, 0); xy.y <= min(mon_pos.y + 1, NUMLINES - 2); xy.y++) {
-
-      if (Game::level->can_step(xy.x, xy.y)) {
-
-        // Cannot walk on a scare monster scroll
-        Item* xy_item = Game::level->get_item(xy.x, xy.y);
-        if (xy_item != nullptr && xy_item->o_type == IO::Scroll &&
-            xy_item->o_which == Scroll::SCARE) {
-          continue;
-        }
+  vector<Step> const* steps = planned_steps(monster, target);
+  if (steps == nullptr) {
+    found_steps.clear();
+    find_steps(monster, target, found_steps);
+    steps = &found_steps;
+  }
 
-        // It can also be a Xeroc, which we shouldn't step on
-        Monster* obj = Game::level->get_monster(xy.x, xy.y);
-        if (obj != nullptr && obj->get_type() == 'X') {
-          continue;
-        }
+  for (Step const& step : *steps) {
 
-        // If we are closer, we pick this as a good position
-        int thisdist = dist_cp(&xy, &target);
-        if (thisdist < curdist) {
-          plcnt = 1;
-          retval = xy;
-          curdist = thisdist;
-        }
+    // If we are closer, we pick this as a good position
+    if (step.distance < curdist) {
+      plcnt = 1;
+      retval = step.coord;
+      curdist = step.distance;
+    }
 
-        // If it's as close as a previous coordinate, we might pick it
-        else if (thisdist == curdist && os_rand_range(++plcnt) == 0) {
-          retval = xy;
-          curdist = thisdist;
-        }
-      }
+    // If it's as close as a previous coordinate, we might pick it
+    else if (step.distance == curdist && os_rand_range(++plcnt) == 0) {
+      retval = step.coord;
+      curdist = step.distance;
     }
   }
   return retval;
@@ -97,11 +226,12 @@ chase_do(Monster* monster)
   // If gold has been taken, run after hero
   room* chaser_room = Game::level->get_room(monster->get_position());
   if (monster->is_greedy() && chaser_room != nullptr && chaser_room->r_goldval == 0) {
-    monster->set_target(&player->get_position());
+    monster->set_target(Target::player());
   }
 
-  Coordinate target = *monster->get_target();
+  Coordinate target = *monster->get_target().position();
   if (monster_try_breathe_fire_on_player(*monster)) {
+    Monster::forget_plans();
     return 0;
   }
 
@@ -111,19 +241,17 @@ chase_do(Monster* monster)
   if (dist_cp(&chase_coord, &target) == 0) {
     // Reached player, and want to fight
     if (chase_coord == player->get_position()) {
+      Monster::forget_plans();
       return fight_against_player(monster);
 
     // Reached shiny thing
-    } else if (target == *monster->get_target()) {
-      for (Item *obj : Game::level->items) {
-        if (monster->get_target() == &obj->get_position()) {
-          Game::level->items.remove(obj);
-          monster->t_pack.push_back(obj);
-          monster->find_new_target();
-          monster->set_not_running();
-          break;
-        }
-      }
+    } else if (monster->get_target().kind == Target::Kind::Item) {
+      Item* obj = Game::level->get_item_by_id(monster->get_target().floor_id);
+      Monster::forget_plans();
+      Game::level->remove_item(obj);
+      monster->t_pack.push_back(obj);
+      monster->find_new_target();
+      monster->set_not_running();
     }
   }
 
@@ -149,6 +277,7 @@ chase_do(Monster* monster)
           !monster->is_levitating()) {
       Coordinate orig_pos = monster->get_position();
 
+      Monster::forget_plans();
       Trap::spring(&monster, chase_coord);
 
       // Monster is dead?
@@ -163,6 +292,8 @@ chase_do(Monster* monster)
     }
 
     // Put monster in new position
+    disturb(monster->get_position());
+    disturb(chase_coord);
     monster->set_position(chase_coord);
     Game::level->set_monster(chase_coord, monster);
   }
@@ -172,19 +303,24 @@ chase_do(Monster* monster)
 
 bool Monster::take_turn()
 {
+  // Someone else got to the item first
+  if (target.kind == Target::Kind::Item && target.position() == nullptr) {
+    set_target(Target::player());
+  }
+
   // Return if stuck
   if (is_held()) {
     return true;
 
 
   // Chase player, if there's a target
-  } else if (is_chasing() && get_target() != nullptr) {
+  } else if (is_chasing() && get_target().position() != nullptr) {
     return chase_do(this) != -1;
 
 
   // If monster sees player and is mean, have a chance to attack
   } else if (is_mean() && player->can_see(*this) && os_rand_range(2)) {
-    set_target(&player->get_position());
+    set_target(Target::player());
     set_chasing();
     return chase_do(this) != -1;
 
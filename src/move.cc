@@ -25,27 +25,6 @@
 using namespace std;
 
 static void handle_surrounding(Coordinate const& nh, int dx, int dy, bool cautious) {
-
-  // Check if we have reached some crossroads (if tunnel)
-  if (cautious) {
-    if (dx == 0 && dy != 0) {
-      if ((Game::level->get_tile(nh.x -1, nh.y - dy) == Tile::Wall &&
-           Game::level->get_tile(nh.x -1, nh.y)      != Tile::Wall) ||
-          (Game::level->get_tile(nh.x +1, nh.y - dy) == Tile::Wall &&
-           Game::level->get_tile(nh.x +1, nh.y     ) != Tile::Wall)) {
-        player->set_not_running();
-      }
-    } else if (dx != 0 && dy == 0) {
-      if ((Game::level->get_tile(nh.x - dx, nh.y -1) == Tile::Wall &&
-           Game::level->get_tile(nh.x,      nh.y -1) != Tile::Wall) ||
-          (Game::level->get_tile(nh.x - dx, nh.y +1) == Tile::Wall &&
-           Game::level->get_tile(nh.x,      nh.y +1) != Tile::Wall)) {
-        player->set_not_running();
-      }
-    }
-  }
-
-
   for (int x = nh.x -1; x <= nh.x +1; ++x) {
     for (int y = nh.y -1; y <= nh.y +1; ++y) {
 
@@ -57,28 +36,17 @@ static void handle_surrounding(Coordinate const& nh, int dx, int dy, bool cautio
         // Only actually notice it if we can see it
         if (cautious && (player->can_sense_monsters() || !monster->is_invisible())) {
           player->set_not_running();
-          continue;
         }
       }
-
-      // Items are interesting
-      Item *item = Game::level->get_item(x, y);
-      if (cautious && item != nullptr) {
-        player->set_not_running();
-        continue;
-      }
-
-      // Always stop near traps and stairs, and doors IFF we can actually move
-      // to it (not diagonal)
-      Tile::Type tile = Game::level->get_tile(x, y);
-      Coordinate tile_coord(x, y);
-      if (cautious &&
-          (tile == Tile::Stairs || tile == Tile::Trap || tile == Tile::OpenDoor)) {
-        player->set_not_running();
-        continue;
-      }
     }
   }
+
+  // Always stop near items, traps, stairs and open doors, and where a corridor
+  // forks. Level looks ahead along the run for those, so most steps only
+  // look for monsters
+  if (cautious && Game::level->is_run_stop(nh, dx, dy)) {
+    player->set_not_running();
+  }
 }
 
 static bool
@@ -125,7 +93,8 @@ move_do_loop(int dx, int dy, bool cautious) {
   nh.x = player->get_position().x + dx;
 
   // If we are too close to the edge of map, treat is as wall automatically
-  if (nh.x < 1 || nh.x >= NUMCOLS -1 || nh.y < 1 || nh.y >= NUMLINES - 1) {
+  if (nh.x < 1 || nh.x >= Game::level->get_width() -1 ||
+      nh.y < 1 || nh.y >= Game::level->get_height() - 1) {
     player->set_not_running();
     return true;
   }
@@ -16,6 +16,10 @@ bool fight_flush  = false;
 bool jump         = true;
 bool passgo       = false;
 bool use_colors   = true;
+int  message_history = 200;
+bool batch_messages  = false;
+int  hibernate_after = 0;
+Animation animation = Animation::Timed;
 
 static bool pickup_potions = true;
 static bool pickup_scrolls = true;
@@ -6,6 +6,17 @@ extern bool fight_flush; // Flush typeahead during battle
 extern bool jump;        // Show running as a series of jumps
 extern bool passgo;      // Follow the turnings in passageways
 extern bool use_colors;  // Use ncurses colors
+extern int  message_history; // Lines kept for repeat_last_messages()
+extern bool batch_messages;  // Never wait at --More--, see IO::message()
+extern int  hibernate_after; // Seconds idle before Game::hibernate(), 0 for never
+
+// How to show missiles, bolts and running
+enum class Animation {
+  Off,     // Don't show them, only where things end up
+  Instant, // Show them, but don't wait for anything
+  Timed,   // Show them at a pace humans can follow
+};
+extern Animation animation;
 
 // Does the play want to automatically pick up items of given type?
 bool option_autopickup(int type);
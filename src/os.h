@@ -10,7 +10,7 @@
 #  include <linux/limits.h>
 #endif
 
-extern unsigned os_rand_seed;
+extern thread_local unsigned os_rand_seed;  // Every thread has its own stream
 
 int         os_rand(void);                   // Return a pseudorandom number
 int         os_rand_range(int max);          // Return a number [0,max[
@@ -18,3 +18,4 @@ size_t      os_rand_range(size_t max);       // Return a number [0,max[
 int         os_usleep(unsigned int usec);    // Sleep for nanoseconds
 std::string os_whoami();                     // Return name for player
 std::string os_homedir();                    // Return user's home directory
+void        os_release_memory();             // Give freed memory back to the system
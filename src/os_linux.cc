@@ -13,13 +13,17 @@
 #include <cstdlib>
 #include <string>
 
+#ifdef __GLIBC__
+#  include <malloc.h>
+#endif
+
 using namespace std;
 
 #include "io.h"
 
 #include "os.h"
 
-unsigned os_rand_seed;
+thread_local unsigned os_rand_seed;
 
 size_t os_rand_range(size_t max) {
   return static_cast<size_t>(os_rand()) % max;
@@ -70,3 +74,9 @@ string os_homedir() {
 }
 
 
+
+void os_release_memory() {
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+}
@@ -1,5 +1,4 @@
 #include <string>
-#include <cmath>
 
 #include "disk.h"
 #include "command_private.h"
@@ -19,6 +18,8 @@
 #include "weapons.h"
 #include "traps.h"
 #include "os.h"
+#include "profile.h"
+#include "ray.h"
 #include "rogue.h"
 #include "colors.h"
 
@@ -49,9 +50,16 @@ bool         player_alerted              = false;
 Player::Player(bool give_equipment) :
   //        str, xp, lvl, armor, hp, dmg
   Character(16,  0,  1,   10,    12, {{1,4}}, Coordinate(), 0, '@'),
-  previous_room(nullptr), senses_monsters(false), speed(0),
+  previous_room(-1), senses_monsters(false), speed(0), next_action(0),
   pack(), equipment(equipment_size(), nullptr), gold(0),
-  nutrition_left(get_starting_nutrition()) {
+  nutrition_left(get_starting_nutrition()), hunger_state(Normal) {
+
+  // Make sure nothing from an earlier game sticks to us
+  player_turns_without_action = 0;
+  player_turns_without_moving = 0;
+  player_alerted = false;
+  monster_flytrap_hit = 0;
+  to_death = false;
 
   if (!give_equipment) {
     return;
@@ -71,6 +79,34 @@ Player::Player(bool give_equipment) :
   equipment.at(Weapon) = dagger;
 }
 
+Player::Player(Player const& other) :
+  Character(other), previous_room(other.previous_room),
+  senses_monsters(other.senses_monsters), speed(other.speed),
+  next_action(other.next_action), pack(),
+  equipment(equipment_size(), nullptr), gold(other.gold),
+  nutrition_left(other.nutrition_left), hunger_state(other.hunger_state) {
+
+  for (Item* item : other.pack) {
+    pack.push_back(item->clone());
+  }
+
+  for (size_t i = 0; i < equipment.size(); ++i) {
+    if (other.equipment.at(i) != nullptr) {
+      equipment.at(i) = other.equipment.at(i)->clone();
+    }
+  }
+}
+
+Player::~Player() {
+  for (Item* item : pack) {
+    delete item;
+  }
+
+  for (Item* item : equipment) {
+    delete item;
+  }
+}
+
 int Player::get_armor() const {
   int ac = Character::get_armor();
 
@@ -109,6 +145,7 @@ bool Player::can_see(Monster const& monster) const {
 }
 
 bool Player::can_see(Coordinate const& coord) const {
+  PROFILE_SCOPE(CanSee);
   if (is_blind()) {
     return false;
   }
@@ -126,31 +163,8 @@ bool Player::can_see(Coordinate const& coord) const {
     return false;
   }
 
-  // Trace the rays, and return false if something blocks
-  Coordinate walker = player->get_position();
-  double distance = sqrt(dist_result);
-  double dx = (coord.x - walker.x) / distance;
-  double dy = (coord.y - walker.y) / distance;
-
-  for (double i = 1; i < distance; ++i) {
-    Coordinate temp(static_cast<int>(round(walker.x + dx * i)),
-                    static_cast<int>(round(walker.y + dy * i)));
-
-    if (temp == coord) {
-      return true;
-    }
-
-    Tile::Type tile = Game::level->get_tile(temp);
-    switch (tile) {
-      case Tile::Wall: case Tile::ClosedDoor:
-        return false;
-
-      case Tile::Floor: case Tile::Stairs: case Tile::Trap:
-      case Tile::OpenDoor:
-        break;
-    }
-  }
-  return true;
+  // Trace the ray, and return false if something blocks
+  return Ray::clear(player_pos, coord, Ray::Walls | Ray::Doors);
 }
 
 string Player::get_attack_string(bool successful_hit) const {
@@ -273,6 +287,14 @@ int Player::get_speed() const {
   return speed;
 }
 
+long long Player::get_next_action() const {
+  return next_action;
+}
+
+void Player::set_next_action(long long tick) {
+  next_action = tick;
+}
+
 void Player::increase_speed() {
   speed++;
   Daemons::daemon_start_fuse(Daemons::decrease_speed, HASTEDURATION, AFTER);
@@ -364,10 +386,12 @@ void Player::teleport(Coordinate const* target)
   Coordinate const old_pos = get_position();
 
   // Set target location (nullptr means we generate a random position)
+  // The player's own tile has no monster on it, so it has to be left out
   if (target == nullptr) {
-    do {
-      Game::level->get_random_room_coord(nullptr, &new_pos, 0, true);
-    } while (new_pos == old_pos);
+    if (!Game::level->get_random_room_coord(nullptr, &new_pos, true, &old_pos)) {
+      Game::io->message("you feel a wrenching sensation");
+      return;
+    }
 
   } else {
     new_pos.y = target->y;
@@ -555,11 +579,11 @@ void Player::rust_armor() {
   }
 }
 
-void Player::set_previous_room(struct room* room) {
-  previous_room = room;
+void Player::set_previous_room(int room_id) {
+  previous_room = room_id;
 }
 
-room* Player::get_previous_room() const {
+int Player::get_previous_room() const {
   return previous_room;
 }
 
@@ -599,7 +623,7 @@ void Player::pack_uncurse() {
   }
 }
 
-void Player::save_player(ofstream& data) {
+void Player::save_player(ostream& data) {
   Disk::save_tag(TAG_PLAYER, data);
   Character* c_player = dynamic_cast<Character*>(player);
   c_player->save(data);
@@ -609,11 +633,20 @@ void Player::save_player(ofstream& data) {
   Disk::save(TAG_SPEED,           player->speed,           data);
   Disk::save(TAG_GOLD,            player->gold,            data);
   Disk::save(TAG_NUTRITION,       player->nutrition_left,  data);
+  Disk::save(TAG_NEXT_ACTION,     player->next_action,     data);
+  Disk::save(TAG_HUNGER,          static_cast<int>(player->hunger_state), data);
+
+  // Not members, but the player's all the same
+  Disk::save(TAG_ASLEEP,          player_turns_without_action, data);
+  Disk::save(TAG_HELD,            player_turns_without_moving, data);
+  Disk::save(TAG_ALERTED,         player_alerted,              data);
+  Disk::save(TAG_TO_DEATH,        to_death,                    data);
 }
 
-void Player::load_player(ifstream& data) {
+void Player::load_player(istream& data) {
   Disk::load_tag(TAG_PLAYER, data);
   player = new Player(false);
+  int hunger;
   Character* c_player = static_cast<Character*>(player);
   if (!c_player->load(data) ||
       !Disk::load(TAG_INVENTORY,       player->pack,           data) ||
@@ -621,7 +654,14 @@ void Player::load_player(ifstream& data) {
       !Disk::load(TAG_SENSES_MONSTERS, player->senses_monsters, data) ||
       !Disk::load(TAG_SPEED,           player->speed,           data) ||
       !Disk::load(TAG_GOLD,            player->gold,            data) ||
-      !Disk::load(TAG_NUTRITION,       player->nutrition_left,  data)) {
+      !Disk::load(TAG_NUTRITION,       player->nutrition_left,  data) ||
+      !Disk::load(TAG_NEXT_ACTION,     player->next_action,     data) ||
+      !Disk::load(TAG_HUNGER,          hunger,                  data) ||
+      !Disk::load(TAG_ASLEEP,          player_turns_without_action, data) ||
+      !Disk::load(TAG_HELD,            player_turns_without_moving, data) ||
+      !Disk::load(TAG_ALERTED,         player_alerted,              data) ||
+      !Disk::load(TAG_TO_DEATH,        to_death,                    data)) {
     error("No player character found");
   }
+  player->hunger_state = static_cast<HungerState>(hunger);
 }
@@ -21,21 +21,23 @@ enum Equipment {
 class Player : public Character {
 public:
   explicit Player(bool give_equipment);
+  ~Player();
 
-  Player(Player const&) = delete;
+  Player(Player const&); // Copies pack and equipment as well
   Player& operator=(Player const&) = delete;
 
-  static void save_player(std::ofstream&);
-  static void load_player(std::ifstream&);
+  static void save_player(std::ostream&);
+  static void load_player(std::istream&);
 
   // Getters
   int get_armor() const override;
   bool has_true_sight() const override;
   bool can_sense_monsters() const;
-  int get_speed() const;
+  int get_speed() const; // Extra moves per turn
+  long long get_next_action() const; // Tick, see scheduler.h
   bool is_stealthy() const;
   int get_strength_with_bonuses() const;
-  struct room* get_previous_room() const;
+  int get_previous_room() const; // Room id, see Level::get_room_id()
 
   // Modifier
   void increase_speed() override;
@@ -56,7 +58,8 @@ public:
   void set_levitating() override;
   void set_not_levitating() override;
   void set_confusing_attack() override;
-  void set_previous_room(struct room* room);
+  void set_previous_room(int room_id);
+  void set_next_action(long long tick);
 
   // player_food.cc
   void         eat(Food*);
@@ -114,9 +117,10 @@ public:
 
 
 private:
-  struct room* previous_room;
+  int          previous_room;
   bool         senses_monsters;
   int          speed;
+  long long    next_action;
 
   // player_pack_management.cc
   enum Window {
@@ -140,7 +144,14 @@ private:
   bool   pack_print_inventory(int subtype);
 
   // player_food.cc
+  enum HungerState {
+    Normal,
+    Hungry,
+    Weak,
+    Starving,
+  };
   int          nutrition_left;
+  HungerState  hunger_state;
 
   static unsigned long long constexpr TAG_PLAYER          = 0x7000000000000000ULL;
   static unsigned long long constexpr TAG_INVENTORY       = 0x7000000000000001ULL;
@@ -149,6 +160,12 @@ private:
   static unsigned long long constexpr TAG_SPEED           = 0x7000000000000004ULL;
   static unsigned long long constexpr TAG_GOLD            = 0x7000000000000005ULL;
   static unsigned long long constexpr TAG_NUTRITION       = 0x7000000000000006ULL;
+  static unsigned long long constexpr TAG_NEXT_ACTION     = 0x7000000000000007ULL;
+  static unsigned long long constexpr TAG_HUNGER          = 0x7000000000000008ULL;
+  static unsigned long long constexpr TAG_ASLEEP          = 0x7000000000000009ULL;
+  static unsigned long long constexpr TAG_HELD            = 0x700000000000000aULL;
+  static unsigned long long constexpr TAG_ALERTED         = 0x700000000000000bULL;
+  static unsigned long long constexpr TAG_TO_DEATH        = 0x700000000000000cULL;
 };
 
 extern Player* player;
@@ -10,20 +10,12 @@
 
 using namespace std;
 
-enum HungerState {
-  Normal,
-  Hungry,
-  Weak,
-  Starving,
-};
-
 static int const full = 5000;
 static int const satiated = 3500;
 static int const hunger_alert = 1000;
 static int const starvation_alert = 300;
 static int const starvation_start = 0;
 static int const starvation_death = -1000;
-static HungerState hunger_state = HungerState::Normal;
 
 void Player::eat(Food* food) {
   if (food->get_type() == Food::Fruit) {
@@ -62,7 +62,7 @@ bool Player::pack_add(Item* obj, bool silent, bool from_floor) {
           ptr->get_damage_plus() == obj->get_damage_plus())
       {
         if (from_floor)
-          Game::level->items.remove(obj);
+          Game::level->remove_item(obj);
         ptr->o_count += obj->o_count;
         ptr->set_position(obj->get_position());
         delete obj;
@@ -86,7 +86,7 @@ bool Player::pack_add(Item* obj, bool silent, bool from_floor) {
   if (!is_picked_up)
   {
     if (from_floor)
-      Game::level->items.remove(obj);
+      Game::level->remove_item(obj);
     pack.push_back(obj);
     for (size_t i = 0; i < pack_size(); ++i) {
       char packch = static_cast<char>(i) + 'a';
@@ -417,8 +417,8 @@ bool Player::pack_unequip(Equipment pos, bool silent_on_success) {
   }
 
   if (!pack_add(obj, true, false)) {
-    Game::level->items.push_back(obj);
     obj->set_position(player->get_position());
+    Game::level->add_item(obj);
     Game::io->message("dropped " + obj->get_description());
 
   } else if (!silent_on_success) {
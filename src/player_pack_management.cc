@@ -87,8 +87,8 @@ bool Player::pack_show_drop(Window window) {
     }
 
     obj = player->pack_remove(obj, true, drop_all);
-    Game::level->items.push_back(obj);
     obj->set_position(player->get_position());
+    Game::level->add_item(obj);
     Game::io->message("dropped " + obj->get_description());
     return true;
   }
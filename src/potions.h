@@ -30,7 +30,7 @@ public:
   ~Potion();
   explicit Potion();     // Random potion
   explicit Potion(Type); // Potion of given type
-  explicit Potion(std::ifstream&);
+  explicit Potion(std::istream&);
   explicit Potion(Potion const&) = default;
 
   Potion* clone() const override;
@@ -52,8 +52,8 @@ public:
   // Misc
   void quaffed_by(Character&); // Someone drank the potion
 
-  virtual void save(std::ofstream&) const override;
-  virtual bool load(std::ifstream&) override;
+  virtual void save(std::ostream&) const override;
+  virtual bool load(std::istream&) override;
 
   // Static
   static std::string  name(Type subtype);
@@ -63,8 +63,8 @@ public:
   static void         set_known(Type subtype);
 
   static void         init_potions();
-  static void         save_potions(std::ofstream&);
-  static void         load_potions(std::ifstream&);
+  static void         save_potions(std::ostream&);
+  static void         load_potions(std::istream&);
   static void         free_potions();
 
 private:
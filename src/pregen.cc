@@ -0,0 +1,86 @@
+#include <chrono>
+#include <future>
+
+#include "game.h"
+#include "os.h"
+#include "profile.h"
+
+#include "pregen.h"
+
+using namespace std;
+
+struct Built {
+  Level* level;
+  int    levels_without_food;
+  chrono::steady_clock::duration build_time;
+};
+
+static Pregen::Inputs pending_inputs;
+static future<Built>  pending;    // Level being built
+static future<void>   disposing;  // Level being deleted
+
+// Runs on a thread of its own, so the random seed and the Game variables it
+// changes are its own copies (see thread_local)
+static Built build(Pregen::Inputs inputs) {
+  os_rand_seed = inputs.seed;
+  Game::current_level = inputs.depth;
+  Game::levels_without_food = inputs.levels_without_food;
+
+  auto const start = chrono::steady_clock::now();
+  Level* level = new Level(inputs.shape, inputs.place_amulet);
+  return { level, Game::levels_without_food, chrono::steady_clock::now() - start };
+}
+
+static bool same_inputs(Pregen::Inputs const& a, Pregen::Inputs const& b) {
+  return a.depth == b.depth && a.seed == b.seed &&
+    a.levels_without_food == b.levels_without_food &&
+    a.place_amulet == b.place_amulet &&
+    a.shape.width == b.shape.width && a.shape.height == b.shape.height &&
+    a.shape.room_columns == b.shape.room_columns &&
+    a.shape.room_rows == b.shape.room_rows;
+}
+
+static void discard_pending() {
+  if (pending.valid()) {
+    delete pending.get().level;
+  }
+}
+
+void Pregen::start(Inputs const& inputs) {
+  // Only one level at a time, the worker only ever needs the next one
+  discard_pending();
+
+  pending_inputs = inputs;
+  pending = async(launch::async, build, inputs);
+}
+
+Level* Pregen::take(Inputs const& inputs, int& levels_without_food) {
+  if (!pending.valid() || !same_inputs(pending_inputs, inputs)) {
+    start(inputs);
+  }
+
+  Built built = pending.get();
+  levels_without_food = built.levels_without_food;
+
+  // Timed on the worker, but added here where the turn is
+  Profile::add(Profile::LevelBuild, built.build_time);
+  return built.level;
+}
+
+void Pregen::dispose(Level* level) {
+  if (level == nullptr) {
+    return;
+  }
+
+  if (disposing.valid()) {
+    disposing.get();
+  }
+  disposing = async(launch::async, [level] { delete level; });
+}
+
+void Pregen::stop() {
+  discard_pending();
+  if (disposing.valid()) {
+    disposing.get();
+  }
+}
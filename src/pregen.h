@@ -0,0 +1,37 @@
+#pragma once
+
+#include "level.h"
+
+// Building dungeon levels ahead of time
+//
+// What a level looks like depends on a few inputs, mainly its own random seed,
+// which is forked from the game's when the level above it is entered. While
+// the player explores, a worker thread builds the next level down, so going
+// down the stairs only swaps levels. If the inputs changed in the meantime
+// (e.g. the player picked up the amulet), the level is built again from the
+// new inputs, so a seed always gives the same game.
+namespace Pregen {
+
+// Everything a new level depends on
+struct Inputs {
+  int      depth;
+  unsigned seed;
+  int      levels_without_food;
+  bool     place_amulet;
+  Level::Shape shape;
+};
+
+// Start building a level on the worker. Throws away the one built before
+void start(Inputs const& inputs);
+
+// Get the level for inputs, and what levels_without_food is after building
+// it. Uses the worker's level if it was built from the same inputs
+Level* take(Inputs const& inputs, int& levels_without_food);
+
+// Delete a level on the worker. level can be nullptr
+void dispose(Level* level);
+
+// Wait for the worker and throw away what it built
+void stop();
+
+}
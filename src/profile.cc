@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "io.h"
+
+#include "profile.h"
+
+using namespace std;
+
+#ifdef PROFILE
+
+// Histogram buckets are microseconds per turn: below 1, 4, 16, ... 16384, more
+static int constexpr num_buckets = 9;
+
+static char const* const section_names[Profile::NumSections] = {
+  "command", "daemons pre", "daemons post", "monsters", "refresh",
+  "can_see", "get_item", "new_level", "level build",
+};
+
+struct Sums {
+  long long nanoseconds[Profile::NumSections];
+  long long calls[Profile::NumSections];
+};
+
+struct Histogram {
+  long long turns;       // Turns the section ran
+  long long calls;
+  long long nanoseconds;
+  long long max_nanoseconds;
+  long long buckets[num_buckets];
+};
+
+// Only the game's thread ever ends a turn, so sums on other threads are lost
+static thread_local Sums this_turn;
+static Histogram histograms[Profile::NumSections];
+static long long turns = 0;
+
+static int bucket(long long nanoseconds) {
+  long long limit = 1000;
+  int i = 0;
+  while (i < num_buckets - 1 && nanoseconds >= limit) {
+    limit *= 4;
+    ++i;
+  }
+  return i;
+}
+
+static vector<string> report() {
+  vector<string> lines;
+  char line[128];
+
+  snprintf(line, sizeof(line),
+           "%lld turns. Microseconds per turn, and %% of turns under N us", turns);
+  lines.push_back(line);
+  snprintf(line, sizeof(line), "%-12s %6s %5s %7s %7s%4s%4s%4s%4s%4s%4s%4s%4s%5s",
+           "section", "turns", "calls", "avg", "max",
+           "1", "4", "16", "64", "256", "1k", "4k", "16k", "more");
+  lines.push_back(line);
+
+  for (int i = 0; i < Profile::NumSections; ++i) {
+    Histogram const& h = histograms[i];
+    if (h.turns == 0) {
+      snprintf(line, sizeof(line), "%-12s %6d", section_names[i], 0);
+      lines.push_back(line);
+      continue;
+    }
+
+    int written = snprintf(line, sizeof(line), "%-12s %6lld %5lld %7lld %7lld",
+                           section_names[i], h.turns, h.calls / h.turns,
+                           h.nanoseconds / h.turns / 1000, h.max_nanoseconds / 1000);
+    for (int j = 0; j < num_buckets; ++j) {
+      written += snprintf(line + written, sizeof(line) - static_cast<size_t>(written),
+                          j == num_buckets - 1 ? "%5lld" : "%4lld",
+                          100 * h.buckets[j] / h.turns);
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+void Profile::add(Section section, chrono::steady_clock::duration time) {
+  this_turn.nanoseconds[section] +=
+    chrono::duration_cast<chrono::nanoseconds>(time).count();
+  ++this_turn.calls[section];
+}
+
+void Profile::end_turn() {
+  ++turns;
+  for (int i = 0; i < NumSections; ++i) {
+    if (this_turn.calls[i] == 0) {
+      continue;
+    }
+
+    Histogram& h = histograms[i];
+    long long const nanoseconds = this_turn.nanoseconds[i];
+    ++h.turns;
+    h.calls += this_turn.calls[i];
+    h.nanoseconds += nanoseconds;
+    if (nanoseconds > h.max_nanoseconds) {
+      h.max_nanoseconds = nanoseconds;
+    }
+    ++h.buckets[bucket(nanoseconds)];
+  }
+  this_turn = Sums();
+}
+
+void Profile::show() {
+  wclear(Game::io->extra_screen);
+  vector<string> const lines = report();
+  for (size_t i = 0; i < lines.size(); ++i) {
+    mvwaddstr(Game::io->extra_screen, static_cast<int>(i) + 2, 0, lines.at(i).c_str());
+  }
+  Game::io->show_extra_screen("Profile: (press SPACE to return)");
+}
+
+bool Profile::dump(string const& path) {
+  ofstream file(path, fstream::out | fstream::trunc);
+  if (!file) {
+    return false;
+  }
+
+  for (string const& line : report()) {
+    file << line << "\n";
+  }
+  return static_cast<bool>(file);
+}
+
+#else
+
+void Profile::add(__attribute__((unused)) Section section,
+                  __attribute__((unused)) chrono::steady_clock::duration time) {}
+
+void Profile::end_turn() {}
+
+void Profile::show() {
+  Game::io->message("profiling is not compiled in, build with `make profile`");
+}
+
+bool Profile::dump(string const& path) {
+  ofstream file(path, fstream::out | fstream::trunc);
+  file << "Profiling is not compiled in, build with `make profile`\n";
+  return static_cast<bool>(file);
+}
+
+#endif
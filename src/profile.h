@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// Per-turn profiling
+//
+// Build with `make profile` (-DPROFILE) to time the sections below. A section
+// adds up its time and calls over a turn, and command_turn_end() puts the sum
+// into a histogram. Wizards see the result with ^G, and --profile=FILE writes
+// it to FILE on exit. Without PROFILE, PROFILE_SCOPE is empty and nothing is
+// timed, so the game pays nothing for it.
+namespace Profile {
+
+enum Section {
+  Command,        // command_do(), one command or one step of running
+  DaemonsBefore,  // Daemons::daemon_run_before()
+  DaemonsAfter,   // Daemons::daemon_run_after()
+  MonstersMove,   // Monster::all_move()
+  Refresh,        // IO::refresh()
+  CanSee,         // Player::can_see()
+  GetItem,        // Level::get_item()
+  NewLevel,       // Game::new_level(), waiting for the worker included
+  LevelBuild,     // Building a level on the worker (see pregen.h)
+  NumSections
+};
+
+// Add time spent in section to this turn. Times from other threads than the
+// game's are dropped, unless the game's thread adds them itself
+void add(Section section, std::chrono::steady_clock::duration time);
+
+// Put this turn's sums into the histograms and start a new turn
+void end_turn();
+
+// Show the histograms on extra_screen
+void show();
+
+// Write the histograms to path, return false if it could not be written
+bool dump(std::string const& path);
+
+// Adds the time from construction to destruction to a section
+class Timer {
+public:
+  explicit Timer(Section section_)
+    : section(section_), start(std::chrono::steady_clock::now()) {}
+  ~Timer() { add(section, std::chrono::steady_clock::now() - start); }
+
+  Timer(Timer const&) = delete;
+  Timer& operator=(Timer const&) = delete;
+
+private:
+  Section                               section;
+  std::chrono::steady_clock::time_point start;
+};
+
+}
+
+#ifdef PROFILE
+#  define PROFILE_SCOPE(section) Profile::Timer profile_timer(Profile::section)
+#else
+#  define PROFILE_SCOPE(section)
+#endif
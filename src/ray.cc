@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "game.h"
+#include "level.h"
+
+#include "ray.h"
+
+using namespace std;
+
+static bool on_map(Coordinate const& pos) {
+  return pos.x >= 0 && pos.x < Game::level->get_width() &&
+    pos.y >= 0 && pos.y < Game::level->get_height();
+}
+
+// True if pos stops a ray with blockers. Sets monster if one does
+static bool blocks(Coordinate const& pos, int blockers, Monster*& monster) {
+  Tile::Type const tile = Game::level->get_tile(pos);
+  if ((tile == Tile::Wall && (blockers & Ray::Walls)) ||
+      (tile == Tile::ClosedDoor && (blockers & Ray::Doors))) {
+    return true;
+  }
+
+  if (blockers & Ray::Monsters) {
+    monster = Game::level->get_monster(pos);
+    return monster != nullptr;
+  }
+  return false;
+}
+
+// Send the ray off the walls at pos, if it hit any. Returns true if it did
+static bool bounce_off_walls(Coordinate& pos, Coordinate& dir) {
+  int num_bounces = 0;
+  for (;;) {
+    if (!on_map(pos) || Game::level->get_tile(pos) != Tile::Wall ||
+        Game::level->get_monster(pos) != nullptr) {
+      return num_bounces != 0;
+    }
+
+    // A bolt can bounce from one wall straight into another in a corner, but
+    // not forever
+    if (num_bounces > 10) {
+      return true;
+    }
+
+    // Going straight, it comes straight back. Diagonally, it depends on
+    // which side of the wall it hit
+    bool vertical_wall;
+    if (dir.x != 0 && dir.y == 0) {
+      vertical_wall = true;
+
+    } else if (dir.y != 0 && dir.x == 0) {
+      vertical_wall = false;
+
+    } else {
+      int y = dir.y < 0 ? pos.y + 1 : pos.y - 1;
+      vertical_wall = y >= Game::level->get_height() || y <= 0 ||
+        Game::level->get_tile(pos.x, y) == Tile::Wall;
+    }
+
+    if (vertical_wall) {
+      pos.x -= dir.x;
+      dir.x = -dir.x;
+    } else {
+      pos.y -= dir.y;
+      dir.y = -dir.y;
+    }
+    ++num_bounces;
+  }
+}
+
+// numerator / denominator to the nearest integer, halves towards 0
+static int divide_rounded(int numerator, int denominator) {
+  if (numerator < 0) {
+    return -divide_rounded(-numerator, denominator);
+  }
+  return (2 * numerator + denominator - 1) / (2 * denominator);
+}
+
+void Ray::cast(Coordinate const& start, Coordinate const& dir, int blockers,
+               int length, Path& path) {
+  path.cells.clear();
+  path.blocked = false;
+  path.monster = nullptr;
+  if (dir.x == 0 && dir.y == 0) {
+    return;
+  }
+
+  Coordinate pos = start;
+  for (int i = 0; length == no_limit || i < length; ++i) {
+    pos.x += dir.x;
+    pos.y += dir.y;
+    if (!on_map(pos)) {
+      return;
+    }
+
+    path.cells.push_back({ pos, dir, false });
+    if (blocks(pos, blockers, path.monster)) {
+      path.blocked = true;
+      return;
+    }
+  }
+}
+
+void Ray::bounce(Coordinate const& start, Coordinate const& dir_, int length,
+                 Path& path) {
+  path.cells.clear();
+  path.blocked = false;
+  path.monster = nullptr;
+
+  Coordinate pos = start;
+  Coordinate dir = dir_;
+  for (int i = 0; i < length; ++i) {
+    pos.x += dir.x;
+    pos.y += dir.y;
+    bool const bounced = bounce_off_walls(pos, dir);
+    if (!on_map(pos)) {
+      return;
+    }
+    path.cells.push_back({ pos, dir, bounced });
+  }
+}
+
+bool Ray::clear(Coordinate const& from, Coordinate const& to, int blockers) {
+  int const dx = to.x - from.x;
+  int const dy = to.y - from.y;
+  int const steps = max(abs(dx), abs(dy));
+
+  // One tile at a time along the longer side, and as near the line as can
+  // be along the other
+  Monster* monster = nullptr;
+  for (int i = 1; i < steps; ++i) {
+    Coordinate const pos(from.x + divide_rounded(i * dx, steps),
+                         from.y + divide_rounded(i * dy, steps));
+    if (blocks(pos, blockers, monster)) {
+      return false;
+    }
+  }
+  return true;
+}
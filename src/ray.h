@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include "coordinate.h"
+
+class Monster;
+
+// Lines across the level
+//
+// Wands, bolts, thrown things and sight all go from tile to tile along a
+// line. These walk such a line with integers only and put every tile on it
+// into a Path, up to where something is in the way. They change and draw
+// nothing, so callers find out where something would go before it does
+// anything, and animate it afterwards.
+namespace Ray {
+
+// What stops a ray. The edge of the map always does
+enum Blocker {
+  Walls    = 1 << 0,  // Tile::Wall
+  Doors    = 1 << 1,  // Tile::ClosedDoor
+  Monsters = 1 << 2,
+};
+
+int constexpr no_limit = -1;  // Length of a ray which goes until it is stopped
+
+struct Cell {
+  Coordinate pos;
+  Coordinate dir;      // Which way the ray went into this tile
+  bool       bounced;  // Off a wall on the way here, see bounce()
+};
+
+struct Path {
+  std::vector<Cell> cells;    // Tiles passed, not counting the start
+  bool              blocked;  // Last cell is what stopped the ray
+  Monster*          monster;  // In the last cell, if a monster stopped the ray
+};
+
+// From start in dir, a tile at a time, until a blocker is in the way or
+// after length tiles
+void cast(Coordinate const& start, Coordinate const& dir, int blockers,
+          int length, Path& path);
+
+// Like cast(), but walls throw the ray back instead of stopping it, like
+// bolts. Goes the full length, through monsters
+void bounce(Coordinate const& start, Coordinate const& dir, int length,
+            Path& path);
+
+// True if no blocker is between from and to. Where the line could go either
+// way, it keeps close to from, like sight does
+bool clear(Coordinate const& from, Coordinate const& to, int blockers);
+
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "disk.h"
+#include "game.h"
+#include "options.h"
+#include "os.h"
+#include "wizard.h"
+
+#include "replay.h"
+
+using namespace std;
+
+static unsigned long long constexpr TAG_REPLAY  = 0xa000000000000000ULL;
+static unsigned long long constexpr TAG_VERSION = 0xa000000000000001ULL;
+static unsigned long long constexpr TAG_SEED    = 0xa000000000000002ULL;
+static unsigned long long constexpr TAG_WIZARD  = 0xa000000000000003ULL;
+static unsigned long long constexpr TAG_SHAPE   = 0xa000000000000004ULL;
+static unsigned long long constexpr TAG_BATCH   = 0xa000000000000005ULL;
+
+static ofstream* recording = nullptr;
+static ifstream* replaying = nullptr;
+
+static int    replay_delay_usec = 0;
+static size_t replayed_keys = 0;
+static chrono::steady_clock::time_point replay_start;
+
+bool Replay::start_recording(string const& path) {
+  recording = new ofstream(path, fstream::out | fstream::trunc | fstream::binary);
+  if (!*recording) {
+    delete recording;
+    recording = nullptr;
+    return false;
+  }
+
+  Disk::save_tag(TAG_REPLAY, *recording);
+  Disk::save(TAG_VERSION, version, *recording);
+  Disk::save(TAG_SEED, os_rand_seed, *recording);
+  Disk::save(TAG_WIZARD, wizard, *recording);
+  Disk::save(TAG_SHAPE, Game::level_shape.width, *recording);
+  Disk::save(TAG_SHAPE, Game::level_shape.height, *recording);
+  Disk::save(TAG_SHAPE, Game::level_shape.room_columns, *recording);
+  Disk::save(TAG_SHAPE, Game::level_shape.room_rows, *recording);
+  Disk::save(TAG_BATCH, batch_messages, *recording);
+  recording->flush();
+  return true;
+}
+
+bool Replay::start_replay(string const& path, int keys_per_second) {
+  replaying = new ifstream(path, fstream::in | fstream::binary);
+
+  int file_version = 0;
+  if (!*replaying ||
+      !Disk::load_tag(TAG_REPLAY, *replaying) ||
+      !Disk::load(TAG_VERSION, file_version, *replaying) ||
+      file_version != version ||
+      !Disk::load(TAG_SEED, os_rand_seed, *replaying) ||
+      !Disk::load(TAG_WIZARD, wizard, *replaying) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.width, *replaying) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.height, *replaying) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.room_columns, *replaying) ||
+      !Disk::load(TAG_SHAPE, Game::level_shape.room_rows, *replaying) ||
+      !Disk::load(TAG_BATCH, batch_messages, *replaying)) {
+    delete replaying;
+    replaying = nullptr;
+    return false;
+  }
+
+  replay_delay_usec = keys_per_second > 0 ? 1000000 / keys_per_second : 0;
+  replay_start = chrono::steady_clock::now();
+  return true;
+}
+
+bool Replay::is_recording() {
+  return recording != nullptr;
+}
+
+bool Replay::is_replaying() {
+  return replaying != nullptr;
+}
+
+void Replay::record(int ch) {
+  // Flush every key, so we still have the full game if we crash
+  recording->put(static_cast<char>(ch));
+  recording->flush();
+}
+
+int Replay::next_key() {
+  int ch = replaying->get();
+  if (ch == EOF) {
+    return EOF;
+  }
+
+  ++replayed_keys;
+  if (replay_delay_usec > 0) {
+    os_usleep(static_cast<unsigned>(replay_delay_usec));
+  }
+  return ch;
+}
+
+void Replay::print_statistics() {
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - replay_start;
+  double seconds = elapsed.count();
+
+  fprintf(stderr, "Replayed %zu keys in %.3fs (%.0f keys/s)\n",
+          replayed_keys, seconds,
+          seconds > 0 ? static_cast<double>(replayed_keys) / seconds : 0.0);
+}
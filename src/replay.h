@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+// Recording and replaying of games
+//
+// A game is fully determined by its seed, map shape and the keys the player
+// pressed, so a recording is just a small header followed by every key read
+// through io_readchar(), one byte per key. Keys pressed at --More-- are keys
+// too, so whether messages were batched is in the header.
+namespace Replay {
+
+int constexpr version = 6;
+
+// Start writing all keys to path. Call after the seed is set
+bool start_recording(std::string const& path);
+
+// Read header from path and set seed, map shape, message batching (and
+// wizard mode) from it.
+// keys_per_second == 0 means replay as fast as possible
+bool start_replay(std::string const& path, int keys_per_second);
+
+bool is_recording();
+bool is_replaying();
+
+// Store a key the player pressed
+void record(int ch);
+
+// Return the next recorded key, or EOF when the recording is finished
+int next_key();
+
+// Print how many keys were replayed and how fast
+void print_statistics();
+
+}
@@ -0,0 +1,16 @@
+#include "game.h"
+
+#include "scheduler.h"
+
+long long Schedule::turn_start() {
+  return Game::turns * ticks_per_turn;
+}
+
+long long Schedule::delay(int speed) {
+  if (speed > 0) {
+    return ticks_per_turn / speed;
+  } else if (speed < 0) {
+    return ticks_per_turn * (1 - speed);
+  }
+  return ticks_per_turn;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Who acts when
+//
+// Time is counted in ticks, ticks_per_turn of them to a turn (Game::turns).
+// Every actor has the tick of its next action, and acting pushes it on by
+// delay() of the actor's speed, so a hasted monster gets exactly two actions
+// a turn and a slowed one an action every other turn. The queue is ordered by
+// that tick, so a turn only looks at the actors which are due in it.
+namespace Schedule {
+
+// Divisible by 1 to 10, so that many actions a turn come out exact
+long long constexpr ticks_per_turn = 2520;
+
+// First tick of the turn being played
+long long turn_start();
+
+// Ticks from one action to the next at speed. Speed n > 0 means n actions a
+// turn, and n < 0 one action every 1 - n turns (see Monster::get_speed())
+long long delay(int speed);
+
+// Actors by the tick of their next action. Ties go to the one queued first,
+// so actors of the same speed keep their order from turn to turn
+template <class Actor>
+class Queue {
+public:
+  Queue() = default;
+  Queue(Queue const&) = delete;             // Holds pointers to its actors
+  Queue& operator=(Queue const&) = delete;
+
+  // Queue actor, which must not already be queued. Order breaks ties, and
+  // is only for keeping the order of a saved or copied queue
+  void push(Actor* actor, long long tick);
+  void push(Actor* actor, long long tick, unsigned long long order);
+
+  // Unqueue actor, if it is queued
+  void remove(Actor const* actor);
+
+  bool contains(Actor const* actor) const;
+
+  // Add the actors due before tick to due, first one first
+  void list_due(long long before, std::vector<Actor*>& due) const;
+
+  // Take the first actor due before tick out of the queue, and set at to
+  // when it was due. Returns nullptr if none is
+  Actor* pop(long long before, long long& at);
+
+  // When actor is due. Returns false if it isn't queued
+  bool find(Actor const* actor, long long& tick, unsigned long long& order) const;
+
+private:
+  struct Entry {
+    long long          tick;
+    unsigned long long order;
+    Actor*             actor;
+
+    bool operator<(Entry const& other) const {
+      return tick != other.tick ? tick < other.tick : order < other.order;
+    }
+  };
+
+  std::set<Entry> entries;
+  std::unordered_map<Actor const*, typename std::set<Entry>::iterator> where;
+  unsigned long long next_order = 0;
+};
+
+template <class Actor>
+void Queue<Actor>::push(Actor* actor, long long tick) {
+  push(actor, tick, next_order);
+}
+
+template <class Actor>
+void Queue<Actor>::push(Actor* actor, long long tick, unsigned long long order) {
+  if (order >= next_order) {
+    next_order = order + 1;
+  }
+  where[actor] = entries.insert({ tick, order, actor }).first;
+}
+
+template <class Actor>
+void Queue<Actor>::remove(Actor const* actor) {
+  auto it = where.find(actor);
+  if (it != where.end()) {
+    entries.erase(it->second);
+    where.erase(it);
+  }
+}
+
+template <class Actor>
+bool Queue<Actor>::contains(Actor const* actor) const {
+  return where.count(actor) != 0;
+}
+
+template <class Actor>
+void Queue<Actor>::list_due(long long before, std::vector<Actor*>& due) const {
+  for (auto it = entries.begin(); it != entries.end() && it->tick < before; ++it) {
+    due.push_back(it->actor);
+  }
+}
+
+template <class Actor>
+Actor* Queue<Actor>::pop(long long before, long long& at) {
+  if (entries.empty() || entries.begin()->tick >= before) {
+    return nullptr;
+  }
+
+  Entry const first = *entries.begin();
+  entries.erase(entries.begin());
+  where.erase(first.actor);
+  at = first.tick;
+  return first.actor;
+}
+
+template <class Actor>
+bool Queue<Actor>::find(Actor const* actor, long long& tick, unsigned long long& order) const {
+  auto it = where.find(actor);
+  if (it == where.end()) {
+    return false;
+  }
+  tick = it->second->tick;
+  order = it->second->order;
+  return true;
+}
+
+}
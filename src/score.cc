@@ -128,7 +128,7 @@ score_write(struct score* top_ten)
 
 
 static void
-score_insert(struct score* top_ten, int amount, int flags, int death_type)
+score_insert(struct score* top_ten, int amount, int flags, int death_type, int level)
 {
   unsigned uid = getuid();
   for (unsigned i = 0; i < SCORE_MAX; ++i)
@@ -142,7 +142,7 @@ score_insert(struct score* top_ten, int amount, int flags, int death_type)
       top_ten[i].score = amount;
       strcpy(top_ten[i].name, Game::whoami->c_str());
       top_ten[i].flags = flags;
-      top_ten[i].level = Game::current_level;
+      top_ten[i].level = level;
       top_ten[i].death_type = death_type;
       top_ten[i].uid = uid;
 
@@ -198,33 +198,44 @@ score_open(void)
 }
 
 void
-score_show_and_exit(int amount, int flags, int death_type)
+score_show(void)
 {
+  struct score top_ten[SCORE_MAX];
+  memset(top_ten, 0, SCORE_MAX * sizeof(*top_ten));
+  score_read(top_ten);
+  score_print(top_ten);
+}
 
-  if (flags >= 0 || wizard)
-  {
-    char buf[2*MAXSTR];
-    mvaddstr(LINES - 1, 0 , "[Press return to continue]");
-    refresh();
-    wgetnstr(stdscr, buf, 80);
-    putchar('\n');
-  }
+void
+score_record(Game::Result const& result)
+{
+  if (result.ending == Game::Result::Saved || result.ending == Game::Result::Stopped)
+    return;
 
   struct score top_ten[SCORE_MAX];
   memset(top_ten, 0, SCORE_MAX * sizeof(*top_ten));
   score_read(top_ten);
 
   /* Insert her in list if need be */
-  score_insert(top_ten, amount, flags, death_type);
+  score_insert(top_ten, result.score, result.ending, result.cause, result.depth);
+}
 
-  /* Print the highscore */
-  score_print(top_ten);
+void
+score_screen(Game::Result const& result)
+{
+  if (result.ending == Game::Result::Saved || result.ending == Game::Result::Stopped)
+    return;
+
+  mvaddstr(LINES - 1, 0 , "[Press return to continue]");
+  refresh();
+  io_wait_for_key(KEY_ENTER);
+  putchar('\n');
 
-  Game::exit();
+  score_show();
 }
 
 void
-score_win_and_exit(void)
+score_win(void)
 {
   clear();
   addstr(
@@ -248,7 +259,7 @@ score_win_and_exit(void)
   refresh();
   io_wait_for_key(KEY_SPACE);
   player->give_gold(static_cast<int>(player->pack_print_value()));
-  score_show_and_exit(player->get_gold(), 2, ' ');
+  Game::end(Game::Result::Won);
 }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "game.h"
 #include "io.h"
 
 #define SCORE_MAX 10 /* Number of highscore entries */
@@ -7,8 +8,14 @@
 /* Open up the score file for future use */
 int score_open(void);
 
-/* Figure score and post it.  */
-void score_show_and_exit(int amount, int flags, int death_type)
-  __attribute__ ((noreturn));
+/* Print the highscore list */
+void score_show(void);
 
-void score_win_and_exit(void) __attribute__ ((noreturn));
+/* Post the result to the highscore list. Default Game::score_sink */
+void score_record(Game::Result const& result);
+
+/* Wait for the player, then show the highscores. Default Game::screen_sink */
+void score_screen(Game::Result const& result);
+
+/* Show the winning screen and end the game */
+void score_win(void) __attribute__ ((noreturn));
@@ -20,6 +20,7 @@
 #include "potions.h"
 #include "rings.h"
 #include "rogue.h"
+#include "scheduler.h"
 #include "wand.h"
 #include "weapons.h"
 
@@ -79,7 +80,7 @@ bool Scroll::is_magic() const {
   return true;
 }
 
-Scroll::Scroll(std::ifstream& data) {
+Scroll::Scroll(std::istream& data) {
   load(data);
 }
 
@@ -227,14 +228,14 @@ void Scroll::init_scrolls() {
   }
 }
 
-void Scroll::save_scrolls(std::ofstream& data) {
+void Scroll::save_scrolls(std::ostream& data) {
   Disk::save_tag(TAG_SCROLL, data);
   Disk::save(TAG_FAKE_NAME, fake_name, data);
   Disk::save(TAG_KNOWLEDGE, knowledge, data);
   Disk::save(TAG_GUESSES, guesses, data);
 }
 
-void Scroll::load_scrolls(std::ifstream& data) {
+void Scroll::load_scrolls(std::istream& data) {
   if (!Disk::load_tag(TAG_SCROLL, data))           { error("No scrolls found"); }
   if (!Disk::load(TAG_FAKE_NAME, fake_name, data)) { error("Scroll tag error 1"); }
   if (!Disk::load(TAG_KNOWLEDGE, knowledge, data)) { error("Scroll tag error 2"); }
@@ -253,13 +254,13 @@ void Scroll::free_scrolls() {
 }
 
 
-void Scroll::save(std::ofstream& data) const {
+void Scroll::save(std::ostream& data) const {
   Item::save(data);
   static_assert(sizeof(Scroll::Type) == sizeof(int), "Wrong Scroll::Type size");
   Disk::save(TAG_SCROLL, static_cast<int>(subtype), data);
 }
 
-bool Scroll::load(std::ifstream& data) {
+bool Scroll::load(std::istream& data) {
   if (!Item::load(data) ||
       !Disk::load(TAG_SCROLL, reinterpret_cast<int&>(subtype), data)) {
     return false;
@@ -329,8 +330,10 @@ static bool create_monster() {
   } else {
     Monster::Type mon_type = Monster::random_monster_type_for_level();
     Monster *monster = new Monster(mon_type, mp);
-    Game::level->monsters.push_back(monster);
-    Game::level->set_monster(mp, monster);
+    Game::level->add_monster(monster, Schedule::turn_start());
+    if (player->has_ring_with_ability(Ring::AggravateMonsters)) {
+      monster_start_running(&mp);
+    }
     Game::io->message("A " + monster->get_name() +
                       " appears out of thin air");
   }
@@ -345,7 +348,7 @@ static bool food_detection() {
   for (Item const* obj : Game::level->items) {
     if (obj->o_type == IO::Food) {
       food_seen = true;
-      mvwaddcch(Game::io->extra_screen, obj->get_y(), obj->get_x(), IO::Food);
+      Game::io->print_extra(obj->get_x(), obj->get_y(), IO::Food);
     }
   }
 
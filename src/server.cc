@@ -0,0 +1,326 @@
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "io.h"
+#include "os.h"
+
+#include "server.h"
+
+using namespace std;
+
+static size_t constexpr max_header = 256;
+
+static bool  session = false;
+static uid_t client_uid = 0;
+
+bool Server::write_all(int fd, char const* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    } else if (written <= 0) {
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+static bool open_socket(string const& path, sockaddr_un& address, int& fd) {
+  if (path.size() >= sizeof(address.sun_path)) {
+    errno = ENAMETOOLONG;
+    return false;
+  }
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  return fd >= 0;
+}
+
+// The client starts with a line "TERM COLUMNS LINES NAME"
+static bool read_header(int fd, string& term, int& columns, int& lines, string& name) {
+  string header;
+  for (;;) {
+    char ch;
+    if (header.size() >= max_header || read(fd, &ch, 1) != 1) {
+      return false;
+    } else if (ch == '\n') {
+      break;
+    }
+    header += ch;
+  }
+
+  istringstream fields(header);
+  return (fields >> term >> columns >> lines >> name) &&
+    Server::valid_name(term) && Server::valid_name(name) &&
+    columns > 0 && lines > 0;
+}
+
+// Who is at the other end of fd, as the kernel knows it
+static bool peer_uid(int fd, uid_t& uid) {
+#ifdef SO_PEERCRED
+  ucred credentials;
+  socklen_t size = sizeof(credentials);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0) {
+    return false;
+  }
+  uid = credentials.uid;
+  return true;
+#else
+  gid_t gid;
+  return getpeereid(fd, &uid, &gid) == 0;
+#endif
+}
+
+// Runs in the forked session. Makes the client's terminal ours
+static bool start_session(int client, string& whoami) {
+  // Anyone can pick any name, so savefiles go by who connected
+  uid_t uid;
+  if (!peer_uid(client, uid)) {
+    return false;
+  }
+
+  string term;
+  string name;
+  int columns = 0;
+  int lines = 0;
+  if (!read_header(client, term, columns, lines, name)) {
+    static char const message[] = "Bad session header\r\n";
+    Server::write_all(client, message, sizeof(message) - 1);
+    return false;
+  }
+
+  // Curses can't ask a socket how big the terminal is, so tell it
+  setenv("TERM", term.c_str(), 1);
+  setenv("COLUMNS", to_string(columns).c_str(), 1);
+  setenv("LINES", to_string(lines).c_str(), 1);
+
+  if (dup2(client, STDIN_FILENO) < 0 || dup2(client, STDOUT_FILENO) < 0) {
+    return false;
+  }
+  close(client);
+
+  // The server doesn't wait for sessions, but sessions wait for their children
+  signal(SIGCHLD, SIG_DFL);
+
+  session = true;
+  client_uid = uid;
+  whoami = name;
+  os_rand_seed = static_cast<unsigned>(time(nullptr) + getpid());
+  return true;
+}
+
+int Server::listen_on(string const& path, mode_t mode) {
+  // Only a socket left behind by a server which is gone is replaced
+  struct stat status;
+  if (lstat(path.c_str(), &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      errno = EEXIST;
+      return -1;
+    }
+
+    int const other = connect_to(path);
+    if (other >= 0) {
+      close(other);
+      errno = EADDRINUSE;
+      return -1;
+    }
+    unlink(path.c_str());
+  }
+
+  sockaddr_un address;
+  int listener = -1;
+  if (!open_socket(path, address, listener)) {
+    return -1;
+  }
+
+  // Connecting takes write permission on the socket, so this is who can
+  if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+      chmod(path.c_str(), mode) != 0 ||
+      listen(listener, SOMAXCONN) != 0) {
+    int const saved_errno = errno;
+    close(listener);
+    errno = saved_errno;
+    return -1;
+  }
+  return listener;
+}
+
+int Server::connect_to(string const& path) {
+  sockaddr_un address;
+  int fd = -1;
+  if (!open_socket(path, address, fd)) {
+    return -1;
+  }
+
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    int const saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return -1;
+  }
+  return fd;
+}
+
+bool Server::serve(string const& path, string& whoami) {
+  int listener = listen_on(path, 0666);
+  if (listener < 0) {
+    return false;
+  }
+
+  // Sessions are never waited for, so don't keep them around as zombies
+  struct sigaction no_zombies;
+  memset(&no_zombies, 0, sizeof(no_zombies));
+  no_zombies.sa_handler = SIG_IGN;
+  no_zombies.sa_flags = SA_NOCLDWAIT;
+  sigaction(SIGCHLD, &no_zombies, nullptr);
+
+  cerr << "Serving games on " << path << "\n";
+  for (;;) {
+    int client = accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      close(listener);
+      return false;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(listener);
+      if (start_session(client, whoami)) {
+        return true;
+      }
+      _exit(1);
+
+    } else if (pid < 0) {
+      cerr << "Failed to start session: " << strerror(errno) << "\n";
+    }
+    close(client);
+  }
+}
+
+int Server::connect(string const& path, string const& whoami) {
+  int server = connect_to(path);
+  if (server < 0) {
+    cerr << path << ": " << strerror(errno) << "\n";
+    return 1;
+  }
+
+  winsize size;
+  if (ioctl(STDIN_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0) {
+    size.ws_col = NUMCOLS;
+    size.ws_row = NUMLINES;
+  }
+  char const* term = getenv("TERM");
+  string const header = string(term != nullptr ? term : "vt100") + " " +
+    to_string(size.ws_col) + " " + to_string(size.ws_row) + " " + whoami + "\n";
+  if (!write_all(server, header.c_str(), header.size())) {
+    cerr << path << ": " << strerror(errno) << "\n";
+    return 1;
+  }
+
+  // Every key goes to the server as it is pressed, and it does all drawing
+  termios original;
+  bool const is_terminal = tcgetattr(STDIN_FILENO, &original) == 0;
+  if (is_terminal) {
+    termios raw = original;
+    cfmakeraw(&raw);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+  }
+
+  pollfd fds[2] = {
+    { STDIN_FILENO, POLLIN, 0 },
+    { server,       POLLIN, 0 },
+  };
+  char buffer[4096];
+  for (;;) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    if (fds[0].revents != 0) {
+      ssize_t size_read = read(STDIN_FILENO, buffer, sizeof(buffer));
+      if (size_read <= 0 ||
+          !write_all(server, buffer, static_cast<size_t>(size_read))) {
+        break;
+      }
+    }
+
+    if (fds[1].revents != 0) {
+      ssize_t size_read = read(server, buffer, sizeof(buffer));
+      if (size_read <= 0 ||
+          !write_all(STDOUT_FILENO, buffer, static_cast<size_t>(size_read))) {
+        break;
+      }
+    }
+  }
+
+  if (is_terminal) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &original);
+  }
+  close(server);
+  return 0;
+}
+
+bool Server::in_session() {
+  return session;
+}
+
+uid_t Server::session_uid() {
+  return client_uid;
+}
+
+bool Server::client_gone() {
+  pollfd client = { STDIN_FILENO, POLLIN, 0 };
+  int ready = poll(&client, 1, 0);
+  if (ready < 0) {
+    return errno != EINTR;
+  } else if (ready == 0) {
+    return false;
+  } else if (client.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+    return true;
+  }
+
+  // Readable with nothing to read is the end of the stream
+  char ch;
+  ssize_t size_read = recv(STDIN_FILENO, &ch, 1, MSG_PEEK | MSG_DONTWAIT);
+  return size_read == 0 ||
+    (size_read < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+bool Server::valid_name(string const& name) {
+  if (name.empty() || name.size() > 32 || name.at(0) == '.') {
+    return false;
+  }
+  for (char ch : name) {
+    if (!isalnum(static_cast<unsigned char>(ch)) &&
+        ch != '.' && ch != '-' && ch != '_') {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <string>
+
+// Serving games to many players over a Unix domain socket
+//
+// The server listens on a socket, and `misty_mountains --connect=SOCKET` is a
+// thin client which attaches the user's terminal to it. This is one process
+// per player, not many games in one process: the game keeps its state in
+// globals (Game::level, player, the item tables ...) and draws through the
+// one curses screen, so sessions can't share a process. The server forks a
+// session for every client, which needs no pty or login of its own. Code and
+// libraries are shared, but everything the game sets up is the session's own,
+// about 450 KB for an unwatched game on a normal map. Curses keeps a screen
+// per session and only sends what changed.
+//
+// A session whose client goes away is saved, and restored when the same user
+// connects again with the same name. Users are told apart by the uid the
+// kernel gives for the socket's other end, not by the name they send.
+//
+// Not done: many sessions in one process, on an event loop or threads. That
+// needs everything the game keeps in globals and file statics moved into a
+// per-session object, and set_term() switching curses between the sessions'
+// screens.
+namespace Server {
+
+// Listen on path and fork a session for every client. Only returns in a
+// session, once the client's terminal is set up as stdin and stdout, with
+// whoami set to the name it sent. Returns false if the server failed
+bool serve(std::string const& path, std::string& whoami);
+
+// Attach this terminal to the server at path until the session ends.
+// Returns an exit status
+int connect(std::string const& path, std::string const& whoami);
+
+// True if this process is a session forked by serve()
+bool in_session();
+
+// The user whose client the session is for
+uid_t session_uid();
+
+// True if the session's client has hung up. Doesn't wait
+bool client_gone();
+
+// Names must be safe to use in a file name
+bool valid_name(std::string const& name);
+
+// Socket helpers. Return -1 and set errno if they fail. listen_on() replaces
+// a socket nobody listens on, but nothing else, and gives it mode
+int listen_on(std::string const& path, mode_t mode);
+int connect_to(std::string const& path);
+
+// write() all of data, unless fd fails
+bool write_all(int fd, char const* data, size_t size);
+
+}
@@ -1,6 +1,8 @@
 #include <cmath>
 #include <sstream>
 
+#include "disk.h"
+#include "error_handling.h"
 #include "io.h"
 #include "food.h"
 #include "player.h"
@@ -23,6 +25,30 @@ Shop::~Shop() {
   }
 }
 
+Shop::Shop(Shop const& other) : inventory(), limited_inventory() {
+  for (Item* item : other.inventory) {
+    inventory.push_back(item->clone());
+  }
+
+  for (Item* item : other.limited_inventory) {
+    limited_inventory.push_back(item->clone());
+  }
+}
+
+Shop::Shop(istream& data) : inventory(), limited_inventory() {
+  if (!Disk::load_tag(TAG_SHOP, data) ||
+      !Disk::load(TAG_SHOP, inventory, data) ||
+      !Disk::load(TAG_SHOP, limited_inventory, data)) {
+    error("Shop tag error");
+  }
+}
+
+void Shop::save(ostream& data) const {
+  Disk::save_tag(TAG_SHOP, data);
+  Disk::save(TAG_SHOP, inventory, data);
+  Disk::save(TAG_SHOP, limited_inventory, data);
+}
+
 Shop::Shop() {
   inventory.push_back(new class Food(Food::IronRation));
   inventory.push_back(new class Weapon(Weapon::Sling, false));
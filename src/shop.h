@@ -10,10 +10,12 @@ public:
   ~Shop();
 
   explicit Shop();
-  explicit Shop(Shop const&) = default;
+  explicit Shop(Shop const&); // Copies inventory as well
+  explicit Shop(std::istream&);
 
-  Shop& operator=(Shop const&) = default;
-  Shop& operator=(Shop &&) = default;
+  void save(std::ostream&) const;
+
+  Shop& operator=(Shop const&) = delete;
 
   void enter();
 
@@ -28,4 +30,6 @@ private:
   std::list<Item*> limited_inventory;
 
   static int constexpr max_items_per_page = 25;
+
+  static unsigned long long constexpr TAG_SHOP = 0xf000000000000000ULL;
 };
@@ -0,0 +1,84 @@
+#include <sstream>
+#include <string>
+
+#include "daemons.h"
+#include "game.h"
+#include "io.h"
+#include "monster.h"
+#include "os.h"
+#include "potions.h"
+#include "rings.h"
+#include "rogue.h"
+#include "scrolls.h"
+#include "wand.h"
+
+#include "snapshot.h"
+
+using namespace std;
+
+// Copy level and player
+static void copy_game(Level const& from_level, Player const& from_player,
+                      Level*& to_level, Player*& to_player) {
+  to_level = new Level(from_level);
+  to_player = new Player(from_player);
+}
+
+Snapshot::Snapshot()
+  : level(nullptr), player_copy(nullptr), tables(),
+    message_buffer(Game::io->message_buffer), rand_seed(os_rand_seed),
+    next_level_seed(Game::next_level_seed),
+    current_level(Game::current_level),
+    levels_without_food(Game::levels_without_food), turns(Game::turns),
+    turns_without_action(player_turns_without_action),
+    turns_without_moving(player_turns_without_moving),
+    alerted(player_alerted), fighting_to_death(to_death),
+    run_direction(runch), last_direction(dir_ch),
+    flytrap_hits(monster_flytrap_hit) {
+
+  copy_game(*Game::level, *player, level, player_copy);
+
+  ostringstream data;
+  Scroll::save_scrolls(data);
+  Potion::save_potions(data);
+  Ring::save_rings(data);
+  Wand::save_wands(data);
+  Daemons::save_daemons(data);
+  tables = data.str();
+}
+
+Snapshot::~Snapshot() {
+  delete level;
+  delete player_copy;
+}
+
+void Snapshot::restore() const {
+  delete Game::level;
+  delete player;
+  copy_game(*level, *player_copy, Game::level, player);
+
+  istringstream data(tables);
+  Scroll::free_scrolls();
+  Scroll::load_scrolls(data);
+  Potion::free_potions();
+  Potion::load_potions(data);
+  Ring::free_rings();
+  Ring::load_rings(data);
+  Wand::free_wands();
+  Wand::load_wands(data);
+  Daemons::free_daemons();
+  Daemons::load_daemons(data);
+
+  Game::io->message_buffer     = message_buffer;
+  os_rand_seed                 = rand_seed;
+  Game::next_level_seed        = next_level_seed;
+  Game::current_level          = current_level;
+  Game::levels_without_food    = levels_without_food;
+  Game::turns                  = turns;
+  player_turns_without_action  = turns_without_action;
+  player_turns_without_moving  = turns_without_moving;
+  player_alerted               = alerted;
+  to_death                     = fighting_to_death;
+  runch                        = run_direction;
+  dir_ch                       = last_direction;
+  monster_flytrap_hit          = flytrap_hits;
+}
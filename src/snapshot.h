@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+#include "level.h"
+#include "player.h"
+
+// A copy of the running game, kept in memory
+//
+// Taking a snapshot copies the level and the player, and serializes the small
+// tables (identification knowledge, daemons). restore() puts a copy of it
+// back, so the same snapshot can be restored any number of times, e.g. once
+// for every node in a lookahead search.
+class Snapshot {
+public:
+  Snapshot();
+  ~Snapshot();
+
+  Snapshot(Snapshot const&) = delete;
+  Snapshot& operator=(Snapshot const&) = delete;
+
+  // Replace the running game with this snapshot
+  void restore() const;
+
+private:
+  Level*       level;
+  Player*      player_copy;
+  std::string  tables;
+  std::string  message_buffer;
+  unsigned     rand_seed;
+  unsigned     next_level_seed;
+  int          current_level;
+  int          levels_without_food;
+  int          turns;
+  int          turns_without_action;
+  int          turns_without_moving;
+  bool         alerted;
+  bool         fighting_to_death;
+  char         run_direction;
+  char         last_direction;
+  int          flytrap_hits;
+};
@@ -19,6 +19,7 @@ struct Tile {
   Type       type;
   bool       is_passage;
   bool       is_discovered;
+  bool       is_mapped;     // Shown by magic mapping, see IO::print_level_layout()
   bool       is_real;
   bool       is_dark;
   Trap::Type trap_type;
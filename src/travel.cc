@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+#include "game.h"
+#include "io.h"
+#include "level.h"
+#include "monster.h"
+#include "move.h"
+#include "player.h"
+#include "rogue.h"
+
+#include "travel.h"
+
+using namespace std;
+
+static char               running_key = '\0'; // runch while travelling
+static bool               exploring = false;
+static vector<Coordinate> path;               // Tiles to step on, the last one first
+static Coordinate         expected;           // Where the player should be now
+
+// Direction keys, at (dy + 1) * 3 + dx + 1
+static char const step_keys[] = "yku" "h l" "bjn";
+
+// Discovered, and can be walked on without springing anything. Closed
+// doors are opened on the way
+static bool is_walkable(Coordinate const& pos) {
+  if (!Game::level->is_discovered(pos)) {
+    return false;
+  }
+
+  switch (Game::level->get_tile(pos)) {
+    case Tile::Floor: case Tile::OpenDoor: case Tile::ClosedDoor:
+    case Tile::Stairs: return true;
+    case Tile::Wall: case Tile::Trap: return false;
+  }
+  return false;
+}
+
+// Next to a tile which has not been discovered
+static bool is_unexplored(Coordinate const& pos) {
+  for (int y = max(pos.y - 1, 0); y <= min(pos.y + 1, Game::level->get_height() - 1); ++y) {
+    for (int x = max(pos.x - 1, 0); x <= min(pos.x + 1, Game::level->get_width() - 1); ++x) {
+      if (!Game::level->is_discovered(x, y)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Put the shortest way over walkable tiles to the nearest tile which is_goal
+// into path. Returns false if there is no way to any
+template <class Goal>
+static bool find_path(Goal is_goal) {
+  int const width = Game::level->get_width();
+  int const height = Game::level->get_height();
+  Coordinate const& start_pos = player->get_position();
+  int const start = start_pos.y * width + start_pos.x;
+
+  // Search outwards from the player, remembering where each tile was reached from
+  vector<int> came_from(static_cast<size_t>(width * height), -1);
+  vector<int> queue { start };
+  came_from.at(static_cast<size_t>(start)) = start;
+
+  path.clear();
+  for (size_t i = 0; i < queue.size(); ++i) {
+    int const index = queue.at(i);
+    Coordinate const pos(index % width, index / width);
+    if (i != 0 && is_goal(pos)) {
+      for (int at = index; at != start; at = came_from.at(static_cast<size_t>(at))) {
+        path.push_back(Coordinate(at % width, at / width));
+      }
+      return true;
+    }
+
+    // The edge of the map is never walkable, see move_do()
+    for (int y = max(pos.y - 1, 1); y <= min(pos.y + 1, height - 2); ++y) {
+      for (int x = max(pos.x - 1, 1); x <= min(pos.x + 1, width - 2); ++x) {
+        int const next = y * width + x;
+        if (came_from.at(static_cast<size_t>(next)) == -1 &&
+            is_walkable(Coordinate(x, y))) {
+          came_from.at(static_cast<size_t>(next)) = index;
+          queue.push_back(next);
+        }
+      }
+    }
+  }
+  return false;
+}
+
+static void stop() {
+  running_key = '\0';
+  path.clear();
+  player->set_not_running();
+}
+
+// Take the next step on path. Returns true if it took time
+static bool take_step() {
+  if (player->get_position() != expected || monster_is_anyone_seen_by_player()) {
+    stop();
+    return false;
+  }
+
+  // Places stop being unexplored when they are seen from nearby
+  if (exploring && (path.empty() || !is_unexplored(path.front())) &&
+      !find_path(is_unexplored)) {
+    Game::io->message("there is nothing left to explore");
+    stop();
+    return false;
+  }
+
+  // Like command_open(), that takes a move of its own
+  if (Game::level->get_tile(path.back()) == Tile::ClosedDoor) {
+    Game::level->set_tile(path.back(), Tile::OpenDoor);
+    return true;
+  }
+
+  Coordinate const& pos = player->get_position();
+  expected = path.back();
+  path.pop_back();
+  char const key = step_keys[(expected.y - pos.y + 1) * 3 + expected.x - pos.x + 1];
+
+  bool const took_time = move_do(key, false);
+  if (player->get_position() != expected || (path.empty() && !exploring)) {
+    stop();
+  }
+  return took_time;
+}
+
+static bool can_start() {
+  if (player->is_blind()) {
+    Game::io->message("you cannot see where you are going");
+    return false;
+
+  } else if (monster_is_anyone_seen_by_player()) {
+    Game::io->message("cannot travel with monsters nearby");
+    return false;
+  }
+  return true;
+}
+
+static bool start(char ch, bool explore) {
+  running_key = ch;
+  exploring = explore;
+  expected = player->get_position();
+  runch = ch;
+  player->set_running();
+  return take_step();
+}
+
+// Let the player move a cursor to where they want to go. Returns false if
+// they change their mind
+static bool pick_goal(Coordinate& goal) {
+  Game::io->message("where to? (direction keys move, . goes, < or > for the stairs)");
+  goal = player->get_position();
+
+  for (;;) {
+    Coordinate const& camera = Game::io->get_camera();
+    move(goal.y - camera.y, goal.x - camera.x);
+    refresh();
+
+    char const ch = io_readchar(true);
+    switch (ch) {
+      case '.': case ',': case '\n': case '\r': {
+        Game::io->clear_message();
+        return true;
+      }
+
+      case '<': case '>': {
+        Game::io->clear_message();
+        if (!player->has_seen_stairs()) {
+          Game::io->message("you have not found the stairs");
+          return false;
+        }
+        goal = Game::level->get_stairs_pos();
+        return true;
+      }
+
+      case KEY_ESCAPE: {
+        Game::io->clear_message();
+        return false;
+      }
+    }
+
+    // Shift moves the cursor further, like it runs
+    char const* key = strchr(step_keys, tolower(ch));
+    if (ch == '\0' || key == nullptr || *key == ' ') {
+      continue;
+    }
+    int const distance = isupper(ch) ? 8 : 1;
+    int const index = static_cast<int>(key - step_keys);
+
+    // Only where the camera sees, which is all there is to pick from
+    goal.x += (index % 3 - 1) * distance;
+    goal.y += (index / 3 - 1) * distance;
+    goal.x = max(goal.x, max(camera.x, 1));
+    goal.x = min(goal.x, min(camera.x + NUMCOLS - 2, Game::level->get_width() - 2));
+    goal.y = max(goal.y, max(camera.y + 1, 1));
+    goal.y = min(goal.y, min(camera.y + NUMLINES - 2, Game::level->get_height() - 2));
+  }
+}
+
+bool Travel::travel(char ch) {
+  if (in_progress()) {
+    return take_step();
+  } else if (!can_start()) {
+    return false;
+  }
+
+  Coordinate goal;
+  if (!pick_goal(goal)) {
+    return false;
+
+  } else if (goal == player->get_position()) {
+    Game::io->message("you are already there");
+    return false;
+
+  } else if (!find_path([&goal] (Coordinate const& pos) { return pos == goal; })) {
+    Game::io->message("you know of no way there");
+    return false;
+  }
+
+  return start(ch, false);
+}
+
+bool Travel::explore(char ch) {
+  if (in_progress()) {
+    return take_step();
+  } else if (!can_start()) {
+    return false;
+
+  } else if (!find_path(is_unexplored)) {
+    Game::io->message("there is nothing left to explore");
+    return false;
+  }
+
+  return start(ch, true);
+}
+
+bool Travel::in_progress() {
+  return running_key != '\0' && runch == running_key && player->is_running();
+}
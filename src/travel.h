@@ -0,0 +1,23 @@
+#pragma once
+
+// Walking to places the player has already found
+//
+// Travel and explore find a path over discovered tiles once, and then take
+// it a step at a time the way running does, with runch repeating the
+// command. They stop when a monster comes into view, when anything else
+// stops running (see move.cc), and when a step doesn't end up where the path
+// said. The screen is only drawn when they stop.
+namespace Travel {
+
+// Ask where to go, with a cursor or < and > for the stairs, and go there.
+// Returns true if it took time
+bool travel(char ch);
+
+// Go to the nearest discovered tile next to tiles which are not, and on to
+// the next one, until there are none left. Returns true if it took time
+bool explore(char ch);
+
+// True while travel() or explore() is taking steps
+bool in_progress();
+
+}
@@ -9,6 +9,7 @@
 #include "colors.h"
 #include "fight.h"
 #include "misc.h"
+#include "ray.h"
 
 #include "wand.h"
 
@@ -17,15 +18,16 @@ using namespace std;
 // "walk" in the zap direction until we find a target
 static Monster* wand_find_target(int* y, int* x, int dy, int dx) {
 
-  *y = player->get_position().y;
-  *x = player->get_position().x;
+  Ray::Path path;
+  Ray::cast(player->get_position(), Coordinate(dx, dy),
+            Ray::Walls | Ray::Doors | Ray::Monsters, Ray::no_limit, path);
 
-  while (Game::level->can_step(*x, *y)) {
-    *y += dy;
-    *x += dx;
-  }
-
-  return Game::level->get_monster(*x, *y);
+  Coordinate const& end = path.cells.empty()
+    ? player->get_position()
+    : path.cells.back().pos;
+  *y = end.y;
+  *x = end.x;
+  return path.monster;
 }
 
 static void wand_spell_light(void)
@@ -228,8 +230,9 @@ wand_zap(void)
           new_pos.y = y - delta.y;
           new_pos.x = x - delta.x;
 
-          tp->set_target(&player->get_position());
+          tp->set_target(Target::player());
           tp->set_chasing();
+          Game::level->wake_monster(tp);
 
           player->teleport(&new_pos);
         }
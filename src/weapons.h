@@ -51,7 +51,7 @@ public:
   ~Weapon();
   explicit Weapon(Type subtype, bool random_stats);
   explicit Weapon(bool random_stats);
-  explicit Weapon(std::ifstream&);
+  explicit Weapon(std::istream&);
   explicit Weapon(Weapon const&) = default;
 
   Weapon* clone() const override;
@@ -73,8 +73,8 @@ public:
   AmmoType    get_ammo_type() const;
   int         get_ammo_multiplier() const;
 
-  void save(std::ofstream&) const override;
-  bool load(std::ifstream&) override;
+  void save(std::ostream&) const override;
+  bool load(std::istream&) override;
 
   // Static
   static std::string name(Type type);
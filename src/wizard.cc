@@ -243,8 +243,12 @@ void wizard_create_item(void) {
 void wizard_show_map(void) {
   wclear(Game::io->extra_screen);
 
-  for (int y = 1; y < NUMLINES - 1; y++)  {
-    for (int x = 0; x < NUMCOLS; x++) {
+  // What the camera sees
+  Coordinate const& camera = Game::io->get_camera();
+  for (int screen_y = 1; screen_y < NUMLINES - 1; screen_y++)  {
+    for (int screen_x = 0; screen_x < NUMCOLS; screen_x++) {
+      int const x = screen_x + camera.x;
+      int const y = screen_y + camera.y;
       chtype ch = 0;
 
       Monster* monster = Game::level->get_monster(x, y);
@@ -273,7 +277,7 @@ void wizard_show_map(void) {
         ch |= A_STANDOUT;
       }
 
-      mvwaddcch(Game::io->extra_screen, y, x, ch);
+      mvwaddcch(Game::io->extra_screen, screen_y, screen_x, ch);
     }
   }
   Game::io->show_extra_screen("---More (level map)---");
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "error_handling.h"
+
+#include "workers.h"
+
+using namespace std;
+
+// What the threads share. It is only deleted by stop(), so threads still
+// waiting when the program exits find it as they left it
+struct Pool {
+  mutex                         lock;        // Guards everything below
+  condition_variable            work_ready;  // A new run(), or stopping
+  condition_variable            work_done;   // The last part is done
+  vector<thread>                threads;
+  function<void(size_t)> const* work = nullptr;
+  size_t                        parts = 0;
+  size_t                        unfinished = 0;
+  unsigned long long            runs = 0;    // Tells the threads a run() is new
+  exception_ptr                 failure;
+  bool                          stopping = false;
+};
+
+static Pool* pool = nullptr;
+
+// Thread part waits for every run() with that part in it
+static void worker_loop(Pool& pool_, size_t part) {
+  unsigned long long seen = 0;
+  unique_lock<mutex> lock(pool_.lock);
+  for (;;) {
+    pool_.work_ready.wait(lock, [&pool_, &seen] {
+      return pool_.stopping || pool_.runs != seen;
+    });
+    if (pool_.stopping) {
+      return;
+    }
+    seen = pool_.runs;
+    if (part >= pool_.parts) {
+      continue;
+    }
+
+    function<void(size_t)> const& work = *pool_.work;
+    lock.unlock();
+    exception_ptr failure;
+    try {
+      work(part);
+    } catch (...) {
+      failure = current_exception();
+    }
+    lock.lock();
+
+    if (failure && !pool_.failure) {
+      pool_.failure = failure;
+    }
+    if (--pool_.unfinished == 0) {
+      pool_.work_done.notify_one();
+    }
+  }
+}
+
+size_t Workers::count() {
+  static size_t const cores = max(thread::hardware_concurrency(), 1u);
+  return cores;
+}
+
+void Workers::run(size_t parts, function<void(size_t)> const& work) {
+  if (parts > count()) {
+    error("Cannot run " + to_string(parts) + " parts on " + to_string(count()) + " threads");
+  } else if (parts < 2) {
+    if (parts == 1) {
+      work(0);
+    }
+    return;
+  }
+
+  if (pool == nullptr) {
+    pool = new Pool;
+    for (size_t part = 1; part < count(); ++part) {
+      pool->threads.emplace_back(worker_loop, ref(*pool), part);
+    }
+  }
+
+  {
+    lock_guard<mutex> lock(pool->lock);
+    pool->work = &work;
+    pool->parts = parts;
+    pool->unfinished = parts - 1;
+    pool->failure = nullptr;
+    ++pool->runs;
+  }
+  pool->work_ready.notify_all();
+
+  exception_ptr failure;
+  try {
+    work(0);
+  } catch (...) {
+    failure = current_exception();
+  }
+
+  unique_lock<mutex> lock(pool->lock);
+  pool->work_done.wait(lock, [] { return pool->unfinished == 0; });
+  pool->work = nullptr;
+  if (!failure) {
+    failure = pool->failure;
+  }
+  lock.unlock();
+
+  if (failure) {
+    rethrow_exception(failure);
+  }
+}
+
+void Workers::stop() {
+  if (pool == nullptr) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(pool->lock);
+    pool->stopping = true;
+  }
+  pool->work_ready.notify_all();
+  for (thread& worker : pool->threads) {
+    worker.join();
+  }
+  delete pool;
+  pool = nullptr;
+}
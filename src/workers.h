@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Threads for work the game's thread waits for, like planning monster turns
+//
+// Starting a thread costs about as much as planning a few dozen monsters, and
+// there is such work every turn, so the threads are started once and then wait
+// for more. The game's thread does a share of the work too, so run() uses one
+// thread less than there are cores. They are started the first time they are
+// needed, and stopped along with Pregen's (see pregen.h).
+namespace Workers {
+
+// How many parts run() can do at once, the game's thread included. 1 on a
+// single core
+size_t count();
+
+// Call work(part) for every part in [0, parts), each on a thread of its own,
+// and return when all are done. parts must be at most count(). Part 0 runs on
+// the calling thread. If any part throws, run() throws it once all are done
+void run(size_t parts, std::function<void(size_t)> const& work);
+
+// Wait for the threads to finish and let them go
+void stop();
+
+}